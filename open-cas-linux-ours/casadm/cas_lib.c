@@ -297,6 +297,8 @@ static struct name_to_val_mapping stats_filters_names[] = {
 	{ .short_name = "req", .value = STATS_FILTER_REQ },
 	{ .short_name = "blk", .value = STATS_FILTER_BLK },
 	{ .short_name = "err", .value = STATS_FILTER_ERR },
+	{ .short_name = "mem", .value = STATS_FILTER_MEMORY },
+	{ .short_name = "lock", .value = STATS_FILTER_LOCK },
 	{ .short_name = "all", .value = STATS_FILTER_ALL },
 	{ NULL }
 };
@@ -969,7 +971,8 @@ static void check_cache_scheduler(const char *cache_device, const char *elv_name
 
 int start_cache(uint16_t cache_id, unsigned int cache_init,
 		const char *cache_device, ocf_cache_mode_t cache_mode,
-		ocf_cache_line_size_t line_size, int force)
+		ocf_cache_line_size_t line_size, int force,
+		uint64_t memory_budget)
 {
 	int fd = 0;
 	struct kcas_start_cache cmd;
@@ -1000,6 +1003,7 @@ int start_cache(uint16_t cache_id, unsigned int cache_init,
 	cmd.caching_mode = cache_mode;
 	cmd.line_size = line_size;
 	cmd.force = (uint8_t)force;
+	cmd.memory_budget = memory_budget;
 
 	status = run_ioctl_interruptible_retry(fd, KCAS_IOCTL_START_CACHE, &cmd,
 			"Starting cache", cache_id, OCF_CORE_ID_INVALID);
@@ -1007,7 +1011,16 @@ int start_cache(uint16_t cache_id, unsigned int cache_init,
 	if (status < 0) {
 		close(fd);
 
-		if (cmd.ext_err_code == OCF_ERR_NO_FREE_RAM) {
+		if (cmd.ext_err_code == OCF_ERR_NO_FREE_RAM && memory_budget) {
+			cas_printf(LOG_ERR, "Cache metadata does not fit into "
+					"memory budget of %lluMiB.\n",
+					memory_budget / MiB);
+
+			if (64 * KiB > line_size)
+				cas_printf(LOG_ERR, "Try with greater cache line size.\n");
+
+			return FAILURE;
+		} else if (cmd.ext_err_code == OCF_ERR_NO_FREE_RAM) {
 			min_free_ram_gb = cmd.min_free_ram;
 			min_free_ram_gb /= GiB;
 
@@ -1632,7 +1645,7 @@ int illegal_recursive_core(unsigned int cache_id, const char *core_device, int c
 }
 
 int add_core(unsigned int cache_id, unsigned int core_id, const char *core_device,
-		int try_add, int update_path)
+		int try_add, int update_path, int blk_mq)
 {
 	int fd = 0, user_core_path_size;
 	struct kcas_insert_core cmd;
@@ -1688,6 +1701,7 @@ int add_core(unsigned int cache_id, unsigned int core_id, const char *core_devic
 	cmd.core_id = core_id;
 	cmd.try_add = try_add;
 	cmd.update_path = update_path;
+	cmd.blk_mq = blk_mq;
 
 	if (ioctl(fd, KCAS_IOCTL_INSERT_CORE, &cmd) < 0) {
 		close(fd);
@@ -2973,7 +2987,8 @@ int standby_init(int cache_id, ocf_cache_line_size_t line_size,
 			cache_device,
 			ocf_cache_mode_default,
 			line_size,
-			force);
+			force,
+			0);
 }
 
 int standby_load(int cache_id, ocf_cache_line_size_t line_size,
@@ -2984,6 +2999,7 @@ int standby_load(int cache_id, ocf_cache_line_size_t line_size,
 			cache_device,
 			ocf_cache_mode_none,
 			line_size,
+			0,
 			0);
 }
 
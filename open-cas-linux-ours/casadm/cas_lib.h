@@ -76,6 +76,8 @@ enum output_format_t {
 #define STATS_FILTER_BLK (1 << 3)
 #define STATS_FILTER_ERR (1 << 4)
 #define STATS_FILTER_IOCLASS (1 << 5)
+#define STATS_FILTER_MEMORY (1 << 6)
+#define STATS_FILTER_LOCK (1 << 7)
 #define STATS_FILTER_ALL (STATS_FILTER_CONF |	\
 			  STATS_FILTER_USAGE |	\
 			  STATS_FILTER_REQ |	\
@@ -113,7 +115,8 @@ void metadata_memory_footprint(uint64_t size, float *footprint, const char **uni
 
 int start_cache(uint16_t cache_id, unsigned int cache_init,
 		const char *cache_device, ocf_cache_mode_t cache_mode,
-		ocf_cache_line_size_t line_size, int force);
+		ocf_cache_line_size_t line_size, int force,
+		uint64_t memory_budget);
 int stop_cache(uint16_t cache_id, int flush);
 
 #ifdef WI_AVAILABLE
@@ -196,9 +199,11 @@ int set_cache_mode(unsigned int cache_state, unsigned int cache_id, int flush);
  * @param iogroup_id id of iogroup (this parameter is not exposed in user CLI)
  * @param try_add try add core to earlier loaded cache or add to core pool
  * @param update_path try update path to core device
+ * @param blk_mq expose core through native blk-mq request path
  * @return 0 upon successful core addition, 1 upon failure
  */
-int add_core(unsigned int cache_id, unsigned int core_id, const char *core_device, int try_add, int update_path);
+int add_core(unsigned int cache_id, unsigned int core_id, const char *core_device,
+		int try_add, int update_path, int blk_mq);
 
 int get_core_info(int fd, int cache_id, int core_id, struct kcas_core_info *info, bool by_id_path);
 
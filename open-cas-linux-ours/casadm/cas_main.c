@@ -51,8 +51,10 @@ struct command_args{
 	int script_subcmd;
 	int try_add;
 	int update_path;
+	int blk_mq;
 	int detach;
 	int no_flush;
+	uint64_t memory_budget;
 	const char* cache_device;
 	const char* core_device;
 	uint32_t params_type;
@@ -78,8 +80,10 @@ static struct command_args command_args_values = {
 		.script_subcmd = -1,
 		.try_add = false,
 		.update_path = false,
+		.blk_mq = false,
 		.detach = false,
 		.no_flush = false,
+		.memory_budget = 0,
 		.cache_device = NULL,
 		.core_device = NULL,
 		.by_id_path = false,
@@ -141,6 +145,8 @@ int command_handle_option(char *opt, const char **arg)
 		command_args_values.try_add = true;
 	} else if (!strcmp(opt, "update-path")) {
 		command_args_values.update_path = true;
+	} else if (!strcmp(opt, "blk-mq")) {
+		command_args_values.blk_mq = true;
 	} else if (!strcmp(opt, "detach")) {
 		command_args_values.detach = true;
 	} else if (!strcmp(opt, "no-flush")) {
@@ -294,6 +300,13 @@ int start_cache_command_handle_option(char *opt, const char **arg)
 			return FAILURE;
 
 		command_args_values.line_size = atoi((const char*)arg[0]) * KiB;
+	} else if (!strcmp(opt, "memory-budget")) {
+		if (validate_str_num(arg[0], "memory budget", 1,
+				UINT32_MAX) == FAILURE)
+			return FAILURE;
+
+		command_args_values.memory_budget =
+				strtoull((const char*)arg[0], NULL, 10) * MiB;
 	}
 
 	return 0;
@@ -317,6 +330,7 @@ int start_cache_command_handle_option(char *opt, const char **arg)
 #define CACHE_DEVICE_DESC "Caching device to be used"
 #define CORE_DEVICE_DESC "Path to core device"
 #define CACHE_LINE_SIZE_DESC "Set cache line size in kibibytes: {4,8,16,32,64}[KiB] (default: %d)"
+#define MEMORY_BUDGET_DESC "Cap RAM used by cache metadata in mebibytes [MiB]; compact policy structures are picked to fit it (default: no limit)"
 
 
 static cli_option start_options[] = {
@@ -326,6 +340,7 @@ static cli_option start_options[] = {
 	{'f', "force", "Force the creation of cache instance"},
 	{'c', "cache-mode", "Set cache mode from available: {"CAS_CLI_HELP_START_CACHE_MODES"} "CAS_CLI_HELP_START_CACHE_MODES_FULL"; without this parameter Write-Through will be set by default", 1, "NAME"},
 	{'x', "cache-line-size", CACHE_LINE_SIZE_DESC, 1, "NUMBER",  CLI_OPTION_DEFAULT_INT, 0, 0, ocf_cache_line_size_default / KiB},
+	{'m', "memory-budget", MEMORY_BUDGET_DESC, 1, "NUMBER", 0},
 	{0}
 };
 
@@ -436,7 +451,8 @@ int handle_start()
 			command_args_values.cache_device,
 			command_args_values.cache_mode,
 			command_args_values.line_size,
-			command_args_values.force);
+			command_args_values.force,
+			command_args_values.memory_budget);
 
 	return status;
 }
@@ -456,7 +472,7 @@ static cli_option stats_options[] = {
 	{'i', "cache-id", CACHE_ID_DESC, 1, "ID", CLI_OPTION_REQUIRED},
 	{'j', "core-id", "Limit display of core-specific statistics to only ones pertaining to a specific core. If this option is not given, casadm will display statistics pertaining to all cores assigned to given cache instance.", 1, "ID", 0},
 	{'d', "io-class-id", "Display per IO class statistics", 1, "ID", CLI_OPTION_OPTIONAL_ARG},
-	{'f', "filter", "Apply filters from the following set: {all, conf, usage, req, blk, err}", 1, "FILTER-SPEC"},
+	{'f', "filter", "Apply filters from the following set: {all, conf, usage, req, blk, err, mem, lock}", 1, "FILTER-SPEC"},
 	{'o', "output-format", "Output format: {table|csv}", 1, "FORMAT"},
 	{'b', "by-id-path", "Display by-id path to disks instead of short form /dev/sdx"},
 	{0}
@@ -1195,6 +1211,7 @@ static cli_option add_options[] = {
 	{'i', "cache-id", CACHE_ID_DESC, 1, "ID", CLI_OPTION_REQUIRED},
 	{'j', "core-id", CORE_ID_DESC, 1, "ID", 0},
 	{'d', "core-device", CORE_DEVICE_DESC, 1, "DEVICE", CLI_OPTION_REQUIRED},
+	{'q', "blk-mq", "Expose core through native blk-mq request path instead of bio based one"},
 	{0}
 };
 
@@ -1203,7 +1220,7 @@ int handle_add()
 	return add_core(command_args_values.cache_id,
 			command_args_values.core_id,
 			command_args_values.core_device,
-			false, false);
+			false, false, command_args_values.blk_mq);
 }
 
 static cli_option remove_options[] = {
@@ -1783,7 +1800,8 @@ int script_handle() {
 			command_args_values.core_id,
 			command_args_values.core_device,
 			command_args_values.try_add,
-			command_args_values.update_path
+			command_args_values.update_path,
+			false
 			);
 	case script_cmd_remove_core:
 		return remove_core(
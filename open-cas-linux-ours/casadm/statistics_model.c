@@ -38,6 +38,8 @@
 
 #define UNIT_REQUESTS "Requests"
 #define UNIT_BLOCKS "4KiB Blocks"
+#define UNIT_KIB "KiB"
+#define UNIT_USEC "us"
 
 static inline float fraction(uint64_t numerator, uint64_t denominator)
 {
@@ -294,6 +296,74 @@ static void print_req_stats(const struct ocf_stats_requests *stats,
 					 stats->total.value);
 }
 
+static inline uint64_t memory_fraction(uint64_t size, uint64_t total)
+{
+	return total ? size * 10000 / total : 0;
+}
+
+static void print_memory_row(FILE *outfile, const char *title,
+		uint64_t size, uint64_t total)
+{
+	print_val_perc_table_row(outfile, title, UNIT_KIB,
+			memory_fraction(size, total), "%llu", size / KiB);
+}
+
+static void print_memory_stats(const struct ocf_cache_memory_footprint *fp,
+		FILE *outfile)
+{
+	uint64_t total = fp->total;
+
+	print_table_header(outfile, 4, "Memory usage", "Size",
+			   "%", "[Units]");
+
+	print_val_perc_table_section(outfile, "Superblock", UNIT_KIB,
+			memory_fraction(fp->superblock, total), "%llu",
+			fp->superblock / KiB);
+	print_memory_row(outfile, "Partitions", fp->partitions, total);
+	print_memory_row(outfile, "Cores", fp->cores, total);
+	print_memory_row(outfile, "Cleaning", fp->cleaning, total);
+	print_memory_row(outfile, "LRU", fp->lru, total);
+	print_memory_row(outfile, "Collision", fp->collision, total);
+	print_memory_row(outfile, "List info", fp->list_info, total);
+	print_memory_row(outfile, "Hash", fp->hash, total);
+
+	print_val_perc_table_section(outfile, "Cache line locks", UNIT_KIB,
+			memory_fraction(fp->cache_line_locks, total), "%llu",
+			fp->cache_line_locks / KiB);
+	print_memory_row(outfile, "Metadata locks", fp->metadata_locks, total);
+	print_memory_row(outfile, "Cleaning policy", fp->cleaning_policy, total);
+	print_memory_row(outfile, "Promotion policy", fp->promotion_policy,
+			total);
+
+	print_val_perc_table_section(outfile, "Total", UNIT_KIB, 10000, "%llu",
+			total / KiB);
+	if (fp->budget) {
+		/* Percentage column shows how much of the budget is used */
+		print_val_perc_table_row(outfile, "Budget", UNIT_KIB,
+				memory_fraction(total, fp->budget), "%llu",
+				fp->budget / KiB);
+	}
+}
+
+static void print_lock_stats(const struct ocf_cache_lock_stats *stats,
+		uint64_t requests, FILE *outfile)
+{
+	print_table_header(outfile, 4, "Cache line locks", "Count",
+			   "%", "[Units]");
+
+	/* Share of all requests that had to wait for a lock */
+	print_val_perc_table_section(outfile, "Lock waits", UNIT_REQUESTS,
+			fraction(stats->waits, requests), "%lu",
+			stats->waits);
+	/* Share of lock waits not served from queue waiter pool */
+	print_val_perc_table_row(outfile, "Waiter allocations", UNIT_REQUESTS,
+			fraction(stats->waiter_allocs, stats->waits),
+			"%lu", stats->waiter_allocs);
+
+	print_val_perc_table_section(outfile, "Wait time", UNIT_USEC, 10000,
+			"%lu", stats->wait_time_ns / 1000);
+}
+
 #define get_stat_name(__dst, __len, __name, __postfix) \
 	memset(__dst, 0, __len); \
 	snprintf(__dst, __len, "%s%s", __name, __postfix);
@@ -667,6 +737,29 @@ static int cache_stats(int ctrl_fd, const struct kcas_cache_info *cache_info,
 	if (stats_filters & STATS_FILTER_COUNTERS)
 		cache_stats_counters(&cache_stats, outfile, stats_filters);
 
+	if (stats_filters & STATS_FILTER_MEMORY) {
+		struct kcas_cache_memory memory = { .cache_id = cache_id };
+
+		if (ioctl(ctrl_fd, KCAS_IOCTL_CACHE_MEMORY, &memory)) {
+			print_err(memory.ext_err_code);
+			return FAILURE;
+		}
+
+		print_memory_stats(&memory.footprint, outfile);
+	}
+
+	if (stats_filters & STATS_FILTER_LOCK) {
+		struct kcas_cache_lock_stats lock = { .cache_id = cache_id };
+
+		if (ioctl(ctrl_fd, KCAS_IOCTL_CACHE_LOCK_STATS, &lock)) {
+			print_err(lock.ext_err_code);
+			return FAILURE;
+		}
+
+		print_lock_stats(&lock.stats, cache_stats.req.total.value,
+				outfile);
+	}
+
 	return SUCCESS;
 }
 
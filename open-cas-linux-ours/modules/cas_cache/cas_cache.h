@@ -59,6 +59,7 @@ struct cache_priv {
 	ocf_queue_t mngt_queue;
 	void *attach_context;
 	bool cache_exp_obj_initialized;
+	uint32_t io_queues_no;
 	ocf_queue_t io_queues[];
 };
 
@@ -880,6 +880,7 @@ void _cas_cls_rule_destroy(struct cas_classifier *cls,
 		_cas_cls_free_condition(cls, c);
 	}
 
+	kfree(r->condition_array);
 	kfree(r);
 }
 
@@ -891,6 +892,29 @@ void cas_cls_rule_destroy(ocf_cache_t cache, struct cas_cls_rule *r)
 	_cas_cls_rule_destroy(cls, r);
 }
 
+/* Flatten rule conditions list into array walked by classification */
+static int _cas_cls_rule_compile(struct cas_cls_rule *r)
+{
+	struct cas_cls_condition *c;
+	unsigned i = 0;
+
+	list_for_each_entry(c, &r->conditions, list)
+		i++;
+
+	r->condition_array = kmalloc_array(i, sizeof(*r->condition_array),
+			GFP_KERNEL);
+	if (!r->condition_array)
+		return -ENOMEM;
+
+	r->condition_count = i;
+
+	i = 0;
+	list_for_each_entry(c, &r->conditions, list)
+		r->condition_array[i++] = c;
+
+	return 0;
+}
+
 /* Create rule from text description. @rule might be overwritten */
 static struct cas_cls_rule *_cas_cls_rule_create(struct cas_classifier *cls,
 		ocf_part_id_t part_id, char *rule)
@@ -907,7 +931,11 @@ static struct cas_cls_rule *_cas_cls_rule_create(struct cas_classifier *cls,
 
 	r->part_id = part_id;
 	INIT_LIST_HEAD(&r->conditions);
+	r->condition_array = NULL;
+	r->condition_count = 0;
 	result = _cas_cls_parse_conditions(cls, r, rule);
+	if (!result)
+		result = _cas_cls_rule_compile(r);
 	if (result) {
 		_cas_cls_rule_destroy(cls, r);
 		return ERR_PTR(result);
@@ -916,47 +944,60 @@ static struct cas_cls_rule *_cas_cls_rule_create(struct cas_classifier *cls,
 	return r;
 }
 
-/* Update rule associated with given io class */
-void cas_cls_rule_apply(ocf_cache_t cache,
-		ocf_part_id_t part_id, struct cas_cls_rule *new)
+/* Rebuild spare rule set from rules bound to io classes and publish it.
+ * Must be called with cls->lock held */
+static void _cas_cls_rule_set_publish(struct cas_classifier *cls)
 {
+	struct cas_cls_rule_set *set;
+	unsigned i;
+
+	cls->rule_set_idx ^= 1;
+	set = &cls->rule_sets[cls->rule_set_idx];
+
+	set->count = 0;
+	for (i = 0; i < OCF_USER_IO_CLASS_MAX; i++) {
+		if (cls->rules[i])
+			set->rules[set->count++] = cls->rules[i];
+	}
+
+	rcu_assign_pointer(cls->rule_set, set);
+}
+
+/* Replace rules for io classes [first, first + count) with @new, publish new
+ * rule set and destroy replaced rules once no classification can see them */
+/* Update rules of all io classes with single rule set swap */
+void cas_cls_rules_apply(ocf_cache_t cache, struct cas_cls_rule **new)
+{
+	struct cas_cls_rule *old[OCF_USER_IO_CLASS_MAX];
 	struct cas_classifier *cls;
-	struct cas_cls_rule *old = NULL, *elem;
-	struct list_head *item, *_n;
+	unsigned i;
 
 	cls = cas_get_classifier(cache);
 	BUG_ON(!cls);
 
-	write_lock(&cls->lock);
+	mutex_lock(&cls->lock);
 
-	/* Walk through list of rules in reverse order (tail to head), visiting
-	 * rules from high to low part_id */
-	list_for_each_prev_safe(item, _n, &cls->rules) {
-		elem = list_entry(item, struct cas_cls_rule, list);
-
-		if (elem->part_id == part_id) {
-			old = elem;
-			list_del(item);
-		}
-
-		if (elem->part_id < part_id)
-			break;
+	for (i = 0; i < OCF_USER_IO_CLASS_MAX; i++) {
+		old[i] = cls->rules[i];
+		cls->rules[i] = new[i];
 	}
 
-	/* Insert new element past loop cursor */
-	if (new)
-		list_add(&new->list, item);
+	_cas_cls_rule_set_publish(cls);
 
-	write_unlock(&cls->lock);
+	/* Wait until previous rule set is no longer in use - it is both
+	 * referencing old rules and going to be rebuilt by next update */
+	synchronize_rcu();
 
-	_cas_cls_rule_destroy(cls, old);
+	mutex_unlock(&cls->lock);
 
-	if (old)
-		CAS_CLS_DEBUG_MSG("Removed rule for class %d\n", part_id);
-	if (new)
-		CAS_CLS_DEBUG_MSG("New rule for class  %d\n", part_id);
+	for (i = 0; i < OCF_USER_IO_CLASS_MAX; i++) {
+		_cas_cls_rule_destroy(cls, old[i]);
 
-	return;
+		if (old[i])
+			CAS_CLS_DEBUG_MSG("Removed rule for class %d\n", i);
+		if (new[i])
+			CAS_CLS_DEBUG_MSG("New rule for class  %d\n", i);
+	}
 }
 
 /*
@@ -978,14 +1019,17 @@ static int _cas_cls_rule_err_to_cass_err(int err)
 	}
 }
 
-/* Create and apply classification rule for given class id */
-static int _cas_cls_rule_init(ocf_cache_t cache, ocf_part_id_t part_id)
+/* Create classification rule for given class id from its current name */
+static int _cas_cls_rule_init(ocf_cache_t cache, ocf_part_id_t part_id,
+		struct cas_cls_rule **rule)
 {
 	struct cas_classifier *cls;
 	struct ocf_io_class_info *info;
 	struct cas_cls_rule *r;
 	int result;
 
+	*rule = NULL;
+
 	cls = cas_get_classifier(cache);
 	if (!cls)
 		 return -EINVAL;
@@ -1013,7 +1057,7 @@ static int _cas_cls_rule_init(ocf_cache_t cache, ocf_part_id_t part_id)
 		goto exit;
 	}
 
-	cas_cls_rule_apply(cache, part_id, r);
+	*rule = r;
 
 exit:
 	kfree(info);
@@ -1065,19 +1109,19 @@ int cas_cls_rule_create(ocf_cache_t cache,
 void cas_cls_deinit(ocf_cache_t cache)
 {
 	struct cas_classifier *cls;
-	struct list_head *item, *n;
-	struct cas_cls_rule *r = NULL;
+	unsigned i;
 
 	cls = cas_get_classifier(cache);
 	ENV_BUG_ON(!cls);
 
-	list_for_each_safe(item, n, &cls->rules) {
-		r = list_entry(item, struct cas_cls_rule, list);
-		list_del(item);
-		_cas_cls_rule_destroy(cls, r);
+	/* No I/O is being classified any more, rules can go right away */
+	for (i = 0; i < OCF_USER_IO_CLASS_MAX; i++) {
+		_cas_cls_rule_destroy(cls, cls->rules[i]);
+		cls->rules[i] = NULL;
 	}
 
 	destroy_workqueue(cls->wq);
+	mutex_destroy(&cls->lock);
 
 	kfree(cls);
 	cas_set_classifier(cache, NULL);
@@ -1096,7 +1140,7 @@ static struct cas_classifier *_cas_cls_init(void)
 	if (!cls)
 		return ERR_PTR(-ENOMEM);
 
-	INIT_LIST_HEAD(&cls->rules);
+	RCU_INIT_POINTER(cls->rule_set, &cls->rule_sets[0]);
 
 	cls->wq = alloc_workqueue("kcas_clsd", WQ_UNBOUND | WQ_FREEZABLE, 1);
 	if (!cls->wq) {
@@ -1104,7 +1148,7 @@ static struct cas_classifier *_cas_cls_init(void)
 		return ERR_PTR(-ENOMEM);
 	}
 
-	rwlock_init(&cls->lock);
+	mutex_init(&cls->lock);
 
 	CAS_CLS_MSG(KERN_INFO, "Initialized IO classifier\n");
 
@@ -1114,6 +1158,7 @@ static struct cas_classifier *_cas_cls_init(void)
 /* Initialize classifier and create rules for existing I/O classes */
 int cas_cls_init(ocf_cache_t cache)
 {
+	struct cas_cls_rule *rules[OCF_USER_IO_CLASS_MAX] = {};
 	struct cas_classifier *cls;
 	unsigned result = 0;
 	unsigned i;
@@ -1123,18 +1168,24 @@ int cas_cls_init(ocf_cache_t cache)
 		return PTR_ERR(cls);
 	cas_set_classifier(cache, cls);
 
-	/* Update rules for all I/O classes except 0 - this is default for all
+	/* Create rules for all I/O classes except 0 - this is default for all
 	 * unclassified I/O */
 	for (i = 1; i < OCF_USER_IO_CLASS_MAX; i++) {
-		result = _cas_cls_rule_init(cache, i);
+		result = _cas_cls_rule_init(cache, i, &rules[i]);
 		if (result)
 			break;
 	}
 
-	if (result)
+	if (result) {
+		while (i--)
+			_cas_cls_rule_destroy(cls, rules[i]);
 		cas_cls_deinit(cache);
+		return result;
+	}
 
-	return result;
+	cas_cls_rules_apply(cache, rules);
+
+	return 0;
 }
 
 /* Determine whether io matches rule */
@@ -1142,14 +1193,13 @@ static cas_cls_eval_t cas_cls_process_rule(struct cas_classifier *cls,
 		struct cas_cls_rule *r, struct cas_cls_io *io,
 		ocf_part_id_t *part_id)
 {
-	struct list_head *item;
 	struct cas_cls_condition *c;
 	cas_cls_eval_t ret = cas_cls_eval_no, rr;
+	unsigned i;
 
 	CAS_CLS_DEBUG_TRACE(" Processing rule for class %d\n", r->part_id);
-	list_for_each(item, &r->conditions) {
-
-		c = list_entry(item, struct cas_cls_condition, list);
+	for (i = 0; i < r->condition_count; i++) {
+		c = r->condition_array[i];
 
 		if (!ret.yes && c->l_op == cas_cls_logical_and)
 			break;
@@ -1213,10 +1263,11 @@ ocf_part_id_t cas_cls_classify(ocf_cache_t cache, struct bio *bio)
 {
 	struct cas_classifier *cls;
 	struct cas_cls_io io = {};
-	struct list_head *item;
+	struct cas_cls_rule_set *set;
 	struct cas_cls_rule *r;
 	ocf_part_id_t part_id = 0;
 	cas_cls_eval_t ret;
+	unsigned i;
 
 	cls = cas_get_classifier(cache);
 	if (!cls)
@@ -1224,17 +1275,18 @@ ocf_part_id_t cas_cls_classify(ocf_cache_t cache, struct bio *bio)
 
 	_cas_cls_get_bio_context(bio, &io);
 
-	read_lock(&cls->lock);
+	rcu_read_lock();
+	set = rcu_dereference(cls->rule_set);
 	CAS_CLS_DEBUG_TRACE("%s\n", "Starting processing");
-	list_for_each(item, &cls->rules) {
-		r = list_entry(item, struct cas_cls_rule, list);
+	for (i = 0; i < set->count; i++) {
+		r = set->rules[i];
 		ret = cas_cls_process_rule(cls, r, &io, &part_id);
 		if (ret.yes)
 			part_id = r->part_id;
 		if (ret.stop)
 			break;
 	}
-	read_unlock(&cls->lock);
+	rcu_read_unlock();
 
 	return part_id;
 }
@@ -11,26 +11,48 @@
 /* Rule matches 1:1 with io class. It contains multiple conditions with
  * associated logical operator (and/or) */
 struct cas_cls_rule {
-	/* Rules list element */
-	struct list_head list;
-
 	/* Associated partition id */
 	ocf_part_id_t part_id;
 
 	/* Conditions for this rule */
 	struct list_head conditions;
+
+	/* Conditions in evaluation order, built once rule is parsed */
+	struct cas_cls_condition **condition_array;
+
+	/* Number of conditions in condition_array */
+	unsigned condition_count;
+};
+
+/* Immutable snapshot of rules in ascending io class order, evaluated by
+ * classifier under RCU. Replaced as a whole whenever rules change. */
+struct cas_cls_rule_set {
+	/* Number of valid entries in rules */
+	unsigned count;
+
+	struct cas_cls_rule *rules[OCF_USER_IO_CLASS_MAX];
 };
 
 /* Classifier context - one per cache instance. */
 struct cas_classifier {
-	/* Rules list head */
-	struct list_head rules;
+	/* Rules set currently visible to classification */
+	struct cas_cls_rule_set __rcu *rule_set;
 
 	/* Directory inode resolving workqueue */
 	struct workqueue_struct *wq;
 
-	/* Lock for rules list */
-	rwlock_t lock __attribute__((aligned(64)));
+	/* Serializes rule updates */
+	struct mutex lock;
+
+	/* Rules bound to io classes, indexed by io class id */
+	struct cas_cls_rule *rules[OCF_USER_IO_CLASS_MAX];
+
+	/* Rule set double buffer - the one not published is free to rebuild
+	 * as each update waits for grace period before returning */
+	struct cas_cls_rule_set rule_sets[2];
+
+	/* Index of published rule set in rule_sets */
+	unsigned rule_set_idx;
 };
 
 struct cas_cls_condition_handler;
@@ -11,10 +11,18 @@
 #include "utils/utils_mpool.h"
 #include "threads.h"
 
+extern u32 data_page_order;
+
 struct env_mpool *cas_bvec_pool;
 
 struct cas_reserve_pool *cas_bvec_pages_rpool;
 
+/* Higher order page chunks reserve pool, NULL if disabled */
+struct cas_reserve_pool *cas_bvec_hpages_rpool;
+
+/* Order of page chunks used for data buffers, 0 if disabled */
+static unsigned int cas_data_page_order;
+
 #define CAS_ALLOC_PAGE_LIMIT 1024
 #define PG_cas PG_private
 
@@ -74,18 +82,106 @@ static int _cas_page_get_cpu(struct page *page)
 	return page->private;
 }
 
+static void _cas_free_hpage_rpool(void *allocator_ctx, void *item)
+{
+	struct page *page = virt_to_page(item);
+
+	_cas_page_clear_priv(page);
+	__free_pages(page, cas_data_page_order);
+}
+
+static void *_cas_alloc_hpage_rpool(void *allocator_ctx, int cpu)
+{
+	struct page *page;
+
+	page = alloc_pages(GFP_NOIO | __GFP_NORETRY | __GFP_NOWARN |
+			__GFP_COMP, cas_data_page_order);
+	if (!page)
+		return NULL;
+
+	_cas_page_set_priv(page);
+	_cas_page_set_cpu(page, cpu);
+	return page_address(page);
+}
+
 /* *** CONTEXT DATA OPERATIONS *** */
 
 /*
- *
+ * Pages recycled through reserve pools hold stale data and have to be
+ * cleared by hand, fresh pages are zeroed by page allocator which skips
+ * the second pass when init_on_alloc already did it.
+ */
+static struct page *_cas_ctx_data_page_get(bool zero)
+{
+	void *page_addr;
+	struct page *page;
+	int cpu;
+
+	page_addr = cas_rpool_try_get(cas_bvec_pages_rpool, &cpu);
+	if (!page_addr)
+		return alloc_page(GFP_NOIO | (zero ? __GFP_ZERO : 0));
+
+	if (zero)
+		memset(page_addr, 0, PAGE_SIZE);
+
+	page = virt_to_page(page_addr);
+	_cas_page_set_cpu(page, cpu);
+	return page;
+}
+
+static struct page *_cas_ctx_data_chunk_get(bool zero)
+{
+	void *page_addr;
+	struct page *page;
+	int cpu;
+
+	page_addr = cas_rpool_try_get(cas_bvec_hpages_rpool, &cpu);
+	if (!page_addr) {
+		/* Don't try hard, caller falls back to single pages */
+		return alloc_pages(GFP_NOIO | __GFP_NORETRY | __GFP_NOWARN |
+				__GFP_COMP | (zero ? __GFP_ZERO : 0),
+				cas_data_page_order);
+	}
+
+	if (zero)
+		memset(page_addr, 0, PAGE_SIZE << cas_data_page_order);
+
+	page = virt_to_page(page_addr);
+	_cas_page_set_cpu(page, cpu);
+	return page;
+}
+
+/*
+ * Returns number of pages released
+ */
+static uint32_t _cas_ctx_data_page_put(struct page *page)
+{
+	unsigned int order = compound_order(page);
+	struct cas_reserve_pool *rpool = order ?
+			cas_bvec_hpages_rpool : cas_bvec_pages_rpool;
+
+	if (!(_cas_page_test_priv(page) && !cas_rpool_try_put(rpool,
+			page_address(page), _cas_page_get_cpu(page)))) {
+		__free_pages(page, order);
+	}
+
+	return 1 << order;
+}
+
+/*
+ * Data buffer is built of page chunks of cas_data_page_order when enabled,
+ * so single bio_vec may span several physically contiguous pages. The
+ * number of bio_vecs is therefore not known up front - vector is always
+ * allocated for worst case of single pages and freed by number of pages
+ * it describes.
  */
 ctx_data_t *__cas_ctx_data_alloc(uint32_t pages, bool zalloc)
 {
 	struct blk_data *data;
-	uint32_t i;
-	void *page_addr = NULL;
-	struct page *page = NULL;
-	int cpu;
+	uint32_t i, allocated = 0;
+	uint32_t chunk = 1 << cas_data_page_order;
+	struct page *page;
+	uint32_t len;
 
 	data = env_mpool_new(cas_bvec_pool, pages);
 
@@ -94,48 +190,37 @@ ctx_data_t *__cas_ctx_data_alloc(uint32_t pages, bool zalloc)
 		return NULL;
 	}
 
-	data->size = pages;
+	for (i = 0; allocated < pages; ++i) {
+		page = NULL;
+
+		if (chunk > 1 && pages - allocated >= chunk)
+			page = _cas_ctx_data_chunk_get(zalloc);
 
-	for (i = 0; i < pages; ++i) {
-		page_addr = cas_rpool_try_get(cas_bvec_pages_rpool, &cpu);
-		if (page_addr) {
-			data->vec[i].bv_page = virt_to_page(page_addr);
-			_cas_page_set_cpu(data->vec[i].bv_page, cpu);
-		} else {
-			data->vec[i].bv_page = alloc_page(GFP_NOIO);
-		}
+		if (!page)
+			page = _cas_ctx_data_page_get(zalloc);
 
-		if (!data->vec[i].bv_page)
+		if (!page)
 			break;
 
-		if (zalloc) {
-			if (!page_addr) {
-				page_addr = page_address(
-						data->vec[i].bv_page);
-			}
-			memset(page_addr, 0, PAGE_SIZE);
-		}
+		len = PAGE_SIZE << compound_order(page);
 
-		data->vec[i].bv_len = PAGE_SIZE;
+		data->vec[i].bv_page = page;
+		data->vec[i].bv_len = len;
 		data->vec[i].bv_offset = 0;
+
+		allocated += len >> PAGE_SHIFT;
 	}
 
 	/* One of allocations failed */
-	if (i != pages) {
-		for (pages = 0; pages < i; pages++) {
-			page = data->vec[i].bv_page;
-
-			if (page && !(_cas_page_test_priv(page) &&
-					!cas_rpool_try_put(cas_bvec_pages_rpool,
-					page_address(page),
-					_cas_page_get_cpu(page)))) {
-				__free_page(page);
-			}
-		}
+	if (allocated != pages) {
+		while (i--)
+			_cas_ctx_data_page_put(data->vec[i].bv_page);
 
 		env_mpool_del(cas_bvec_pool, data, pages);
 		data = NULL;
 	} else {
+		data->size = i;
+
 		/* Initialize iterator */
 		cas_io_iter_init(&data->iter, data->vec, data->size);
 	}
@@ -158,24 +243,16 @@ ctx_data_t *cas_ctx_data_zalloc(uint32_t pages)
  */
 void cas_ctx_data_free(ctx_data_t *ctx_data)
 {
-	uint32_t i;
-	struct page *page = NULL;
+	uint32_t i, pages = 0;
 	struct blk_data *data = ctx_data;
 
 	if (!data)
 		return;
 
-	for (i = 0; i < data->size; i++) {
-		page = data->vec[i].bv_page;
-
-		if (!(_cas_page_test_priv(page) && !cas_rpool_try_put(
-				cas_bvec_pages_rpool,
-				page_address(page),
-				_cas_page_get_cpu(page))))
-			__free_page(page);
-	}
+	for (i = 0; i < data->size; i++)
+		pages += _cas_ctx_data_page_put(data->vec[i].bv_page);
 
-	env_mpool_del(cas_bvec_pool, data, data->size);
+	env_mpool_del(cas_bvec_pool, data, pages);
 }
 
 static int _cas_ctx_data_mlock(ctx_data_t *ctx_data)
@@ -195,7 +272,7 @@ void cas_ctx_data_secure_erase(ctx_data_t *ctx_data)
 
 	for (i = 0; i < data->size; i++) {
 		ptr = page_address(data->vec[i].bv_page);
-		memset(ptr, 0, PAGE_SIZE);
+		memset(ptr, 0, data->vec[i].bv_len);
 	}
 }
 
@@ -383,6 +460,7 @@ static const struct ocf_ctx_config ctx_cfg = {
 			.seek = _cas_ctx_seek_data,
 			.copy = _cas_ctx_data_copy,
 			.secure_erase = cas_ctx_data_secure_erase,
+			.zalloc = cas_ctx_data_zalloc,
 		},
 
 		.cleaner = {
@@ -403,13 +481,57 @@ static const struct ocf_ctx_config ctx_cfg = {
 
 /* *** CONTEXT INITIALIZATION *** */
 
+static int _cas_data_hpages_init(void)
+{
+	if (!data_page_order)
+		return 0;
+
+#ifdef CAS_MULTIPAGE_BVEC_SUPPORTED
+	cas_data_page_order = data_page_order;
+
+	cas_bvec_hpages_rpool = cas_rpool_create(
+			CAS_ALLOC_PAGE_LIMIT >> cas_data_page_order,
+			"cas_page_chunk",
+			PAGE_SIZE << cas_data_page_order,
+			_cas_alloc_hpage_rpool, _cas_free_hpage_rpool, NULL);
+	if (!cas_bvec_hpages_rpool) {
+		printk(KERN_ERR "Cannot create reserve pool for "
+				"page chunks of order %u\n",
+				cas_data_page_order);
+		cas_data_page_order = 0;
+		return -ENOMEM;
+	}
+#else
+	printk(KERN_WARNING OCF_PREFIX_SHORT "Multi-page BIO vectors "
+			"are not supported, data_page_order ignored\n");
+#endif
+
+	return 0;
+}
+
+static void _cas_data_hpages_deinit(void)
+{
+	if (!cas_bvec_hpages_rpool)
+		return;
+
+	cas_rpool_destroy(cas_bvec_hpages_rpool, _cas_free_hpage_rpool, NULL);
+	cas_bvec_hpages_rpool = NULL;
+	cas_data_page_order = 0;
+}
+
 int cas_initialize_context(void)
 {
 	int ret;
 
+	ret = cas_rpool_init();
+	if (ret) {
+		printk(KERN_ERR "Cannot initialize reserve pools\n");
+		return ret;
+	}
+
 	ret = ocf_ctx_create(&cas_ctx, &ctx_cfg);
 	if (ret < 0)
-		return ret;
+		goto err_rpool_init;
 
 	cas_bvec_pool = env_mpool_create(sizeof(struct blk_data),
 			sizeof(struct bio_vec), GFP_NOIO, 7, true, NULL,
@@ -422,7 +544,7 @@ int cas_initialize_context(void)
 	}
 
 	cas_bvec_pages_rpool = cas_rpool_create(CAS_ALLOC_PAGE_LIMIT,
-			NULL, PAGE_SIZE, _cas_alloc_page_rpool,
+			"cas_page", PAGE_SIZE, _cas_alloc_page_rpool,
 			_cas_free_page_rpool, NULL);
 	if (!cas_bvec_pages_rpool) {
 		printk(KERN_ERR "Cannot create reserve pool for "
@@ -431,23 +553,31 @@ int cas_initialize_context(void)
 		goto err_mpool;
 	}
 
+	ret = _cas_data_hpages_init();
+	if (ret)
+		goto err_rpool;
+
 	cas_garbage_collector_init();
 
 	ret = block_dev_init();
 	if (ret) {
 		printk(KERN_ERR "Cannot initialize block device layer\n");
-		goto err_rpool;
+		goto err_hpages;
 
 	}
 
 	return 0;
 
+err_hpages:
+	_cas_data_hpages_deinit();
 err_rpool:
 	cas_rpool_destroy(cas_bvec_pages_rpool, _cas_free_page_rpool, NULL);
 err_mpool:
 	env_mpool_destroy(cas_bvec_pool);
 err_ctx:
 	ocf_ctx_put(cas_ctx);
+err_rpool_init:
+	cas_rpool_deinit();
 
 	return ret;
 }
@@ -456,9 +586,11 @@ void cas_cleanup_context(void)
 {
 	cas_garbage_collector_deinit();
 	env_mpool_destroy(cas_bvec_pool);
+	_cas_data_hpages_deinit();
 	cas_rpool_destroy(cas_bvec_pages_rpool, _cas_free_page_rpool, NULL);
 
 	ocf_ctx_put(cas_ctx);
+	cas_rpool_deinit();
 }
 
 /* *** CONTEXT DATA HELPER FUNCTION *** */
@@ -54,6 +54,11 @@ struct blk_data {
 	 */
 	int error;
 
+	/**
+	 * @brief Data belongs to polled bio of exported object
+	 */
+	bool polled;
+
 	/**
 	 * @brief Iterator for accessing data
 	 */
@@ -65,6 +70,16 @@ struct blk_data {
 	struct bio_vec vec[];
 };
 
+/*
+ * Max order of page chunks backing single data buffer bio_vec (64 KiB)
+ */
+#define CAS_DATA_PAGE_ORDER_MAX 4
+
+/*
+ * Max length of single data buffer bio_vec
+ */
+#define CAS_DATA_CHUNK_SIZE_MAX (PAGE_SIZE << CAS_DATA_PAGE_ORDER_MAX)
+
 struct blk_data *cas_alloc_blk_data(uint32_t size, gfp_t flags);
 void cas_free_blk_data(struct blk_data *data);
 
@@ -11,6 +11,8 @@ extern u32 writeback_queue_unblock_size;
 extern u32 unaligned_io;
 extern u32 seq_cut_off_mb;
 extern u32 use_io_scheduler;
+extern u32 inline_resume;
+extern u32 backfill_mode;
 
 struct cas_lazy_thread
 {
@@ -1435,7 +1437,8 @@ int cache_mngt_add_core_to_cache(const char *cache_name, size_t name_len,
 	if (result)
 		goto error_affter_lock;
 
-	result = kcas_core_create_exported_object(core);
+	result = kcas_core_create_exported_object(core,
+			cmd_info && cmd_info->blk_mq);
 	if (result)
 		goto error_after_add_core;
 
@@ -1812,8 +1815,7 @@ int cache_mngt_set_partitions(const char *cache_name, size_t name_len,
 	if (result)
 		goto out_configure;
 
-	for (class_id = 0; class_id < OCF_USER_IO_CLASS_MAX; class_id++)
-		cas_cls_rule_apply(cache, class_id, cls_rule[class_id]);
+	cas_cls_rules_apply(cache, cls_rule);
 
 out_configure:
 	ocf_mngt_cache_unlock(cache);
@@ -1834,7 +1836,7 @@ static int _cache_mngt_create_core_exp_obj(ocf_core_t core, void *cntx)
 {
 	int result;
 
-	result = kcas_core_create_exported_object(core);
+	result = kcas_core_create_exported_object(core, false);
 	if (result)
 		return result;
 
@@ -2019,11 +2021,14 @@ int cache_mngt_create_cache_cfg(struct ocf_mngt_cache_config *cfg,
 	cfg->cache_line_size = cmd->line_size;
 	cfg->pt_unaligned_io = !unaligned_io;
 	cfg->use_submit_io_fast = !use_io_scheduler;
+	cfg->inline_resume = !!inline_resume;
 	cfg->locked = true;
 	cfg->metadata_volatile = false;
 
 	cfg->backfill.max_queue_size = max_writeback_queue_size;
 	cfg->backfill.queue_unblock_size = writeback_queue_unblock_size;
+	cfg->backfill.mode = backfill_mode;
+	cfg->memory_budget = cmd->memory_budget;
 	attach_cfg->cache_line_size = cmd->line_size;
 	attach_cfg->force = cmd->force;
 	attach_cfg->discard_on_start = true;
@@ -2069,11 +2074,12 @@ const struct ocf_queue_ops queue_ops = {
 
 static int _cache_mngt_start_queues(ocf_cache_t cache)
 {
-	uint32_t cpus_no = num_online_cpus();
 	struct cache_priv *cache_priv;
+	uint32_t cpus_no;
 	int result, i;
 
 	cache_priv = ocf_cache_get_priv(cache);
+	cpus_no = cache_priv->io_queues_no;
 
 	for (i = 0; i < cpus_no; i++)
 	{
@@ -2187,6 +2193,8 @@ static int _cache_mngt_cache_priv_init(ocf_cache_t cache)
 	if (!cache_priv)
 		return -ENOMEM;
 
+	cache_priv->io_queues_no = cpus_no;
+
 	cache_priv->stop_context =
 		env_malloc(sizeof(*cache_priv->stop_context), GFP_KERNEL);
 	if (!cache_priv->stop_context)
@@ -3284,6 +3292,48 @@ put:
 	return result;
 }
 
+int cache_mngt_get_memory_footprint(struct kcas_cache_memory *info)
+{
+	int result;
+	ocf_cache_t cache;
+
+	result = mngt_get_cache_by_id(cas_ctx, info->cache_id, &cache);
+	if (result)
+		return result;
+
+	result = _cache_mngt_read_lock_sync(cache);
+	if (result)
+		goto put;
+
+	result = ocf_cache_get_memory_footprint(cache, &info->footprint);
+
+	ocf_mngt_cache_read_unlock(cache);
+put:
+	ocf_mngt_cache_put(cache);
+	return result;
+}
+
+int cache_mngt_get_lock_stats(struct kcas_cache_lock_stats *info)
+{
+	int result;
+	ocf_cache_t cache;
+
+	result = mngt_get_cache_by_id(cas_ctx, info->cache_id, &cache);
+	if (result)
+		return result;
+
+	result = _cache_mngt_read_lock_sync(cache);
+	if (result)
+		goto put;
+
+	result = ocf_cache_get_lock_stats(cache, &info->stats);
+
+	ocf_mngt_cache_read_unlock(cache);
+put:
+	ocf_mngt_cache_put(cache);
+	return result;
+}
+
 int cache_mngt_get_io_class_info(struct kcas_io_class *part)
 {
 	int result;
@@ -94,6 +94,10 @@ int cache_mngt_get_stats(struct kcas_get_stats *stats);
 
 int cache_mngt_get_info(struct kcas_cache_info *info);
 
+int cache_mngt_get_memory_footprint(struct kcas_cache_memory *info);
+
+int cache_mngt_get_lock_stats(struct kcas_cache_lock_stats *info);
+
 int cache_mngt_get_io_class_info(struct kcas_io_class *part);
 
 int cache_mngt_get_core_info(struct kcas_core_info *info);
@@ -40,6 +40,10 @@
 #include <linux/mm.h>
 #include <linux/blk-mq.h>
 #include <linux/ktime.h>
+#include <linux/prefetch.h>
+#include <linux/shrinker.h>
+#include <linux/rcupdate.h>
+#include <linux/mutex.h>
 #include "../cas_disk/exp_obj.h"
 
 #include "generated_defines.h"
@@ -4,6 +4,7 @@
 */
 
 #include "cas_cache.h"
+#include "utils/utils_data.h"
 
 /* Layer information. */
 MODULE_AUTHOR("Intel(R) Corporation");
@@ -33,6 +34,32 @@ MODULE_PARM_DESC(unaligned_io,
 		"Define how to handle I/O requests unaligned to 4 kiB, "
 		"0 - apply PT, 1 - handle by cache");
 
+u32 inline_resume = 0;
+module_param(inline_resume, uint, (S_IRUSR | S_IRGRP));
+MODULE_PARM_DESC(inline_resume,
+		"Resume requests waiting for cache line lock directly in "
+		"unlocking context when possible, 0 - disabled, 1 - enabled");
+
+u32 backfill_mode = ocf_backfill_mode_default;
+module_param(backfill_mode, uint, (S_IRUSR | S_IRGRP));
+MODULE_PARM_DESC(backfill_mode,
+		"Define how cache is backfilled on read miss, "
+		"0 - complete user request first and backfill from a copy, "
+		"1 - backfill from user pages without copying");
+
+u32 data_page_order = 0;
+module_param(data_page_order, uint, (S_IRUSR | S_IRGRP));
+MODULE_PARM_DESC(data_page_order,
+		"Allocate cache data buffers in physically contiguous chunks "
+		"of 2^order pages, 0 - disabled, max "
+		__stringify(CAS_DATA_PAGE_ORDER_MAX));
+
+u32 data_copy_nt_threshold = 64 * 1024;
+module_param(data_copy_nt_threshold, uint, (S_IRUSR | S_IRGRP));
+MODULE_PARM_DESC(data_copy_nt_threshold,
+		"Data buffer copies of at least this many bytes use "
+		"non-temporal stores to bypass CPU caches, 0 - disabled");
+
 u32 seq_cut_off_mb = 1;
 module_param(seq_cut_off_mb, uint, (S_IRUSR | S_IRGRP));
 MODULE_PARM_DESC(seq_cut_off_mb,
@@ -150,13 +177,34 @@ static int __init cas_init_module(void)
 		return -EINVAL;
 	}
 
+	if (data_page_order > CAS_DATA_PAGE_ORDER_MAX) {
+		printk(KERN_ERR OCF_PREFIX_SHORT
+				"Invalid value for data_page_order parameter\n");
+		return -EINVAL;
+	}
+
+#ifdef CAS_LOCK_STATS
+	result = env_lock_stats_init();
+	if (result) {
+		printk(KERN_ERR OCF_PREFIX_SHORT
+				"Cannot initialize lock statistics\n");
+		return result;
+	}
+#endif
+
 	result = cas_initialize_context();
 	if (result) {
 		printk(KERN_ERR OCF_PREFIX_SHORT
 				"Cannot initialize cache library\n");
-		return result;
+		goto error_lock_stats_init;
 	}
 
+#ifdef CAS_DATA_CPY_SELFTEST
+	result = cas_data_cpy_selftest();
+	if (result)
+		goto error_cas_ctx_init;
+#endif
+
 	result = cas_ctrl_device_init();
 	if (result) {
 		printk(KERN_ERR OCF_PREFIX_SHORT
@@ -171,6 +219,10 @@ static int __init cas_init_module(void)
 
 error_cas_ctx_init:
 	cas_cleanup_context();
+error_lock_stats_init:
+#ifdef CAS_LOCK_STATS
+	env_lock_stats_deinit();
+#endif
 
 	return result;
 }
@@ -181,6 +233,9 @@ static void __exit cas_exit_module(void)
 {
 	cas_ctrl_device_deinit();
 	cas_cleanup_context();
+#ifdef CAS_LOCK_STATS
+	env_lock_stats_deinit();
+#endif
 }
 
 module_exit(cas_exit_module);
@@ -22,6 +22,9 @@ struct _env_allocator {
 	/*!< Size of specific item of memory pool */
 	uint32_t item_size;
 
+	/*!< Should new items be zeroed */
+	bool zero;
+
 	/*!< Number of currently allocated items in pool */
 	atomic_t count __attribute__((aligned(64)));
 };
@@ -49,11 +52,17 @@ void *env_allocator_new(env_allocator *allocator)
 		item = cas_rpool_try_get(allocator->rpool, &cpu);
 
 	if (item) {
-		memset(item->data, 0, allocator->item_size -
-			sizeof(struct _env_allocator_item));
+		if (allocator->zero) {
+			memset(item->data, 0, allocator->item_size -
+				sizeof(struct _env_allocator_item));
+		}
 		BUG_ON(item->used);
-	} else {
+	} else if (allocator->zero) {
 		item = kmem_cache_zalloc(allocator->kmem_cache, GFP_NOIO);
+	} else {
+		item = kmem_cache_alloc(allocator->kmem_cache, GFP_NOIO);
+		if (item)
+			memset(item, 0, sizeof(*item));
 	}
 
 	if (item) {
@@ -94,7 +103,7 @@ static void env_allocator_del_rpool(void *allocator_ctx, void *_item)
 #define ENV_ALLOCATOR_NAME_MAX 128
 
 env_allocator *env_allocator_create_extended(uint32_t size, const char *name,
-	int rpool_limit)
+	int rpool_limit, bool zero)
 {
 	int error = -1;
 	bool retry = true;
@@ -115,6 +124,7 @@ env_allocator *env_allocator_create_extended(uint32_t size, const char *name,
 	}
 
 	allocator->item_size = size + sizeof(struct _env_allocator_item);
+	allocator->zero = zero;
 	allocator->name = kstrdup(name, ENV_MEM_NORMAL);
 
 	if (!allocator->name) {
@@ -176,7 +186,7 @@ err:
 
 env_allocator *env_allocator_create(uint32_t size, const char *name, bool zero)
 {
-	return env_allocator_create_extended(size, name, -1);
+	return env_allocator_create_extended(size, name, -1, zero);
 }
 
 void env_allocator_del(env_allocator *allocator, void *obj)
@@ -300,3 +310,114 @@ void env_sort(void *base, size_t num, size_t size,
 		env_cond_resched();
 	}
 }
+
+/* *** LOCK STATISTICS *** */
+
+#ifdef CAS_LOCK_STATS
+
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+static LIST_HEAD(env_lock_classes);
+static DEFINE_SPINLOCK(env_lock_classes_lock);
+static struct dentry *env_lock_stats_dir;
+
+void env_lock_class_register(struct env_lock_class *cls)
+{
+	if (atomic_xchg(&cls->registered, 1))
+		return;
+
+	spin_lock(&env_lock_classes_lock);
+	list_add_tail(&cls->list, &env_lock_classes);
+	spin_unlock(&env_lock_classes_lock);
+}
+
+static void env_lock_stats_show_hist(struct seq_file *m, const char *name,
+		atomic64_t *hist)
+{
+	int i;
+
+	seq_printf(m, "  %s:", name);
+	for (i = 0; i < ENV_LOCK_STATS_HIST_BUCKETS; i++)
+		seq_printf(m, " %lld", (long long)atomic64_read(&hist[i]));
+	seq_puts(m, "\n");
+}
+
+static int env_lock_stats_show(struct seq_file *m, void *v)
+{
+	struct env_lock_class *cls;
+	int i;
+
+	seq_puts(m, "histogram bucket lower bounds [ns]:");
+	for (i = 0; i < ENV_LOCK_STATS_HIST_BUCKETS; i++)
+		seq_printf(m, " %llu", 1ULL << (2 * i));
+	seq_puts(m, "\n");
+
+	spin_lock(&env_lock_classes_lock);
+	list_for_each_entry(cls, &env_lock_classes, list) {
+		seq_printf(m, "%s\n  acquired: %lld contended: %lld\n",
+				cls->name,
+				(long long)atomic64_read(&cls->acquired),
+				(long long)atomic64_read(&cls->contended));
+		env_lock_stats_show_hist(m, "wait", cls->wait_hist);
+		env_lock_stats_show_hist(m, "hold", cls->hold_hist);
+	}
+	spin_unlock(&env_lock_classes_lock);
+
+	return 0;
+}
+
+static int env_lock_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, env_lock_stats_show, NULL);
+}
+
+/* Any write resets all counters */
+static ssize_t env_lock_stats_write(struct file *file, const char __user *buf,
+		size_t count, loff_t *ppos)
+{
+	struct env_lock_class *cls;
+	int i;
+
+	spin_lock(&env_lock_classes_lock);
+	list_for_each_entry(cls, &env_lock_classes, list) {
+		atomic64_set(&cls->acquired, 0);
+		atomic64_set(&cls->contended, 0);
+		for (i = 0; i < ENV_LOCK_STATS_HIST_BUCKETS; i++) {
+			atomic64_set(&cls->wait_hist[i], 0);
+			atomic64_set(&cls->hold_hist[i], 0);
+		}
+	}
+	spin_unlock(&env_lock_classes_lock);
+
+	return count;
+}
+
+static const struct file_operations env_lock_stats_fops = {
+	.owner = THIS_MODULE,
+	.open = env_lock_stats_open,
+	.read = seq_read,
+	.write = env_lock_stats_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+int env_lock_stats_init(void)
+{
+	env_lock_stats_dir = debugfs_create_dir("cas_cache", NULL);
+	if (IS_ERR_OR_NULL(env_lock_stats_dir))
+		return -ENOMEM;
+
+	debugfs_create_file("lock_stats", 0600, env_lock_stats_dir, NULL,
+			&env_lock_stats_fops);
+
+	return 0;
+}
+
+void env_lock_stats_deinit(void)
+{
+	debugfs_remove_recursive(env_lock_stats_dir);
+	env_lock_stats_dir = NULL;
+}
+
+#endif
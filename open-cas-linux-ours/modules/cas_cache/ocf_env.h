@@ -80,7 +80,7 @@ static inline void env_secure_free(const void *ptr, size_t size)
 typedef struct _env_allocator env_allocator;
 
 env_allocator *env_allocator_create_extended(uint32_t size, const char *name,
-	int rpool_limit);
+	int rpool_limit, bool zero);
 
 env_allocator *env_allocator_create(uint32_t size, const char *name, bool zero);
 
@@ -218,8 +218,177 @@ static inline void env_rmutex_destroy(env_rmutex *rmutex)
 {
 }
 
+/* *** LOCK STATISTICS *** */
+
+#ifdef CAS_LOCK_STATS
+
+/*
+ * Lock contention profiling (CAS_LOCK_STATS=1 build option). Every
+ * env_rwsem/env_rwlock/env_spinlock init call site defines a lock class,
+ * e.g. all hash bucket locks share one class. Statistics are dumped via
+ * debugfs, see ocf_env.c.
+ */
+
+#define ENV_LOCK_STATS_HIST_BUCKETS 16
+
+struct env_lock_class {
+	const char *name;
+	struct list_head list;
+	atomic_t registered;
+
+	atomic64_t acquired;
+	atomic64_t contended;
+	/* bucket i counts times from [4^i, 4^(i+1)) ns */
+	atomic64_t wait_hist[ENV_LOCK_STATS_HIST_BUCKETS];
+	atomic64_t hold_hist[ENV_LOCK_STATS_HIST_BUCKETS];
+};
+
+#define ENV_LOCK_CLASS(lock) ({ \
+	static struct env_lock_class __env_lock_class = { \
+		.name = KBUILD_BASENAME ": " #lock, \
+	}; \
+	&__env_lock_class; \
+})
+
+void env_lock_class_register(struct env_lock_class *cls);
+
+int env_lock_stats_init(void);
+
+void env_lock_stats_deinit(void);
+
+static inline unsigned env_lock_stats_bucket(uint64_t ns)
+{
+	unsigned bucket = ns ? (fls64(ns) - 1) / 2 : 0;
+
+	return min_t(unsigned, bucket, ENV_LOCK_STATS_HIST_BUCKETS - 1);
+}
+
+/* Called when the lock could not be taken immediately, returns wait start */
+static inline uint64_t env_lock_stats_contended(struct env_lock_class *cls)
+{
+	if (!cls)
+		return 0;
+
+	atomic64_inc(&cls->contended);
+
+	return ktime_get_ns();
+}
+
+/* Called with the lock taken, returns acquisition time for hold tracking */
+static inline uint64_t env_lock_stats_acquired(struct env_lock_class *cls,
+		uint64_t wait_start)
+{
+	uint64_t now;
+
+	if (!cls)
+		return 0;
+
+	atomic64_inc(&cls->acquired);
+	now = ktime_get_ns();
+
+	if (wait_start) {
+		atomic64_inc(&cls->wait_hist[
+				env_lock_stats_bucket(now - wait_start)]);
+	}
+
+	return now;
+}
+
+static inline void env_lock_stats_released(struct env_lock_class *cls,
+		uint64_t acquired)
+{
+	if (!cls || !acquired)
+		return;
+
+	atomic64_inc(&cls->hold_hist[
+			env_lock_stats_bucket(ktime_get_ns() - acquired)]);
+}
+
+/* Take the lock, counting contention and wait time if trylock fails */
+#define ENV_LOCK_STATS_LOCK(cls, trylock, lock) ({ \
+	uint64_t __wait_start = 0; \
+	if (!(trylock)) { \
+		__wait_start = env_lock_stats_contended(cls); \
+		lock; \
+	} \
+	env_lock_stats_acquired(cls, __wait_start); \
+})
+
+#endif
+
 /* *** RW SEMAPHORE *** */
 
+#ifdef CAS_LOCK_STATS
+
+typedef struct {
+	struct rw_semaphore sem;
+	struct env_lock_class *cls;
+	uint64_t acquired;
+} env_rwsem;
+
+static inline int __env_rwsem_init(env_rwsem *s, struct env_lock_class *cls)
+{
+	init_rwsem(&s->sem);
+	env_lock_class_register(cls);
+	s->cls = cls;
+	s->acquired = 0;
+	return 0;
+}
+
+#define env_rwsem_init(s) __env_rwsem_init((s), ENV_LOCK_CLASS(s))
+
+static inline void env_rwsem_up_read(env_rwsem *s)
+{
+	up_read(&s->sem);
+}
+
+static inline void env_rwsem_down_read(env_rwsem *s)
+{
+	ENV_LOCK_STATS_LOCK(s->cls, down_read_trylock(&s->sem),
+			down_read(&s->sem));
+}
+
+static inline int env_rwsem_down_read_trylock(env_rwsem *s)
+{
+	if (!down_read_trylock(&s->sem)) {
+		env_lock_stats_contended(s->cls);
+		return -OCF_ERR_NO_LOCK;
+	}
+
+	env_lock_stats_acquired(s->cls, 0);
+	return 0;
+}
+
+static inline void env_rwsem_up_write(env_rwsem *s)
+{
+	env_lock_stats_released(s->cls, s->acquired);
+	up_write(&s->sem);
+}
+
+static inline void env_rwsem_down_write(env_rwsem *s)
+{
+	s->acquired = ENV_LOCK_STATS_LOCK(s->cls, down_write_trylock(&s->sem),
+			down_write(&s->sem));
+}
+
+static inline int env_rwsem_down_write_trylock(env_rwsem *s)
+{
+	if (!down_write_trylock(&s->sem)) {
+		env_lock_stats_contended(s->cls);
+		return -OCF_ERR_NO_LOCK;
+	}
+
+	s->acquired = env_lock_stats_acquired(s->cls, 0);
+	return 0;
+}
+
+static inline int env_rwsem_is_locked(env_rwsem *s)
+{
+	return rwsem_is_locked(&s->sem);
+}
+
+#else
+
 typedef struct rw_semaphore env_rwsem;
 
 static inline int env_rwsem_init(env_rwsem *s)
@@ -263,6 +432,8 @@ static inline int env_rwsem_is_locked(env_rwsem *s)
 	return rwsem_is_locked(s);
 }
 
+#endif
+
 static inline int env_rwsem_destroy(env_rwsem *s)
 {
 	return 0;
@@ -411,8 +582,102 @@ static inline u64 env_atomic64_cmpxchg(atomic64_t *a, u64 old, u64 new)
 	return atomic64_cmpxchg(a, old, new);
 }
 
+static inline void env_smp_rmb(void)
+{
+	smp_rmb();
+}
+
+static inline void env_smp_wmb(void)
+{
+	smp_wmb();
+}
+
+static inline void env_smp_mb(void)
+{
+	smp_mb();
+}
+
+static inline void env_prefetch(const void *addr)
+{
+	prefetch(addr);
+}
+
+static inline void env_prefetchw(const void *addr)
+{
+	prefetchw(addr);
+}
+
 /* *** SPIN LOCKS *** */
 
+#ifdef CAS_LOCK_STATS
+
+typedef struct {
+	spinlock_t lock;
+	struct env_lock_class *cls;
+	uint64_t acquired;
+} env_spinlock;
+
+static inline int __env_spinlock_init(env_spinlock *l,
+		struct env_lock_class *cls)
+{
+	spin_lock_init(&l->lock);
+	env_lock_class_register(cls);
+	l->cls = cls;
+	l->acquired = 0;
+	return 0;
+}
+
+#define env_spinlock_init(l) __env_spinlock_init((l), ENV_LOCK_CLASS(l))
+
+static inline void env_spinlock_lock(env_spinlock *l)
+{
+	l->acquired = ENV_LOCK_STATS_LOCK(l->cls, spin_trylock(&l->lock),
+			spin_lock(&l->lock));
+}
+
+static inline int env_spinlock_trylock(env_spinlock *l)
+{
+	if (!spin_trylock(&l->lock)) {
+		env_lock_stats_contended(l->cls);
+		return -OCF_ERR_NO_LOCK;
+	}
+
+	l->acquired = env_lock_stats_acquired(l->cls, 0);
+	return 0;
+}
+
+static inline void env_spinlock_unlock(env_spinlock *l)
+{
+	env_lock_stats_released(l->cls, l->acquired);
+	spin_unlock(&l->lock);
+}
+
+static inline void env_spinlock_lock_irq(env_spinlock *l)
+{
+	local_irq_disable();
+	env_spinlock_lock(l);
+}
+
+static inline void env_spinlock_unlock_irq(env_spinlock *l)
+{
+	env_spinlock_unlock(l);
+	local_irq_enable();
+}
+
+#define env_spinlock_lock_irqsave(l, flags) \
+		do { \
+			local_irq_save(flags); \
+			env_spinlock_lock(l); \
+		} while (0)
+
+#define env_spinlock_unlock_irqrestore(l, flags) \
+		do { \
+			env_spinlock_unlock(l); \
+			local_irq_restore(flags); \
+		} while (0)
+
+#else
+
 typedef spinlock_t env_spinlock;
 
 static inline int env_spinlock_init(env_spinlock *l)
@@ -446,18 +711,63 @@ static inline void env_spinlock_unlock_irq(env_spinlock *l)
 	spin_unlock_irq(l);
 }
 
-static inline void env_spinlock_destroy(env_spinlock *l)
-{
-}
-
 #define env_spinlock_lock_irqsave(l, flags) \
 		spin_lock_irqsave((l), (flags))
 
 #define env_spinlock_unlock_irqrestore(l, flags) \
 		spin_unlock_irqrestore((l), (flags))
 
+#endif
+
+static inline void env_spinlock_destroy(env_spinlock *l)
+{
+}
+
 /* *** RW LOCKS *** */
 
+#ifdef CAS_LOCK_STATS
+
+typedef struct {
+	rwlock_t lock;
+	struct env_lock_class *cls;
+	uint64_t acquired;
+} env_rwlock;
+
+static inline void __env_rwlock_init(env_rwlock *l, struct env_lock_class *cls)
+{
+	rwlock_init(&l->lock);
+	env_lock_class_register(cls);
+	l->cls = cls;
+	l->acquired = 0;
+}
+
+#define env_rwlock_init(l) __env_rwlock_init((l), ENV_LOCK_CLASS(l))
+
+static inline void env_rwlock_read_lock(env_rwlock *l)
+{
+	ENV_LOCK_STATS_LOCK(l->cls, read_trylock(&l->lock),
+			read_lock(&l->lock));
+}
+
+static inline void env_rwlock_read_unlock(env_rwlock *l)
+{
+	read_unlock(&l->lock);
+}
+
+static inline void env_rwlock_write_lock(env_rwlock *l)
+{
+	l->acquired = ENV_LOCK_STATS_LOCK(l->cls, write_trylock(&l->lock),
+			write_lock(&l->lock));
+}
+
+static inline void env_rwlock_write_unlock(env_rwlock *l)
+{
+	env_lock_stats_released(l->cls, l->acquired);
+	write_unlock(&l->lock);
+}
+
+#else
+
 typedef rwlock_t env_rwlock;
 
 static inline void env_rwlock_init(env_rwlock *l)
@@ -485,6 +795,8 @@ static inline void env_rwlock_write_unlock(env_rwlock *l)
 	write_unlock(l);
 }
 
+#endif
+
 static inline void env_rwlock_destroy(env_rwlock *l)
 {
 }
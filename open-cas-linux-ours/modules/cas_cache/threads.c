@@ -16,6 +16,9 @@ struct cas_thread_info {
 	struct completion compl;
 	struct completion sync_compl;
 	wait_queue_head_t wq;
+	struct mutex run_lock;
+	spinlock_t poll_lock;
+	struct list_head polled_bios;
 	struct task_struct *thread;
 };
 
@@ -42,7 +45,9 @@ static int _cas_io_queue_thread(void *data)
 		wait_event_interruptible(info->wq, ocf_queue_pending_io(q) ||
 				atomic_read(&info->stop));
 
+		mutex_lock(&info->run_lock);
 		ocf_queue_run(q);
+		mutex_unlock(&info->run_lock);
 
 	} while (!atomic_read(&info->stop) || ocf_queue_pending_io(q));
 
@@ -131,6 +136,9 @@ static int _cas_create_thread(struct cas_thread_info **pinfo,
 	init_completion(&info->compl);
 	init_completion(&info->sync_compl);
 	init_waitqueue_head(&info->wq);
+	mutex_init(&info->run_lock);
+	spin_lock_init(&info->poll_lock);
+	INIT_LIST_HEAD(&info->polled_bios);
 
 	va_start(args, fmt);
 	vsnprintf(info->name, sizeof(info->name), fmt, args);
@@ -204,6 +212,82 @@ void cas_kick_queue_thread(ocf_queue_t q)
 }
 
 
+void cas_queue_add_polled_bio(ocf_queue_t q, struct cas_polled_bio *pb)
+{
+	struct cas_thread_info *info = ocf_queue_get_priv(q);
+	unsigned long flags;
+
+	spin_lock_irqsave(&info->poll_lock, flags);
+	list_add_tail(&pb->list, &info->polled_bios);
+	spin_unlock_irqrestore(&info->poll_lock, flags);
+}
+
+void cas_queue_del_polled_bio(ocf_queue_t q, struct cas_polled_bio *pb)
+{
+	struct cas_thread_info *info = ocf_queue_get_priv(q);
+	unsigned long flags;
+
+	spin_lock_irqsave(&info->poll_lock, flags);
+	list_del(&pb->list);
+	spin_unlock_irqrestore(&info->poll_lock, flags);
+}
+
+/*
+ * Poll bottom device for the oldest polled bio of the queue. Bio is moved to
+ * the end of the list, so that subsequent calls visit the others too. Bio
+ * completion removes it from the list, so reference is held while polling.
+ */
+static int _cas_poll_queue_bios(struct cas_thread_info *info)
+{
+	struct cas_polled_bio *pb;
+	struct bio *bio = NULL;
+	unsigned long flags;
+	int result;
+
+	spin_lock_irqsave(&info->poll_lock, flags);
+	if (!list_empty(&info->polled_bios)) {
+		pb = list_first_entry(&info->polled_bios,
+				struct cas_polled_bio, list);
+		list_move_tail(&pb->list, &info->polled_bios);
+		bio = pb->bio;
+		bio_get(bio);
+	}
+	spin_unlock_irqrestore(&info->poll_lock, flags);
+
+	if (!bio)
+		return 0;
+
+	result = CAS_BIO_POLL(bio);
+	bio_put(bio);
+
+	return result;
+}
+
+/*
+ * Process single request of the queue in context of polling task and poll
+ * bottom devices for bios submitted with polled flag from this queue. OCF
+ * queue must not be run concurrently from several contexts, so it is skipped
+ * if queue thread (or another poller) is processing it at the moment.
+ */
+int cas_poll_queue_thread(ocf_queue_t q)
+{
+	struct cas_thread_info *info = ocf_queue_get_priv(q);
+	int result = 0;
+
+	if (!info)
+		return 0;
+
+	if (mutex_trylock(&info->run_lock)) {
+		if (ocf_queue_pending_io(q)) {
+			ocf_queue_run_single(q);
+			result = 1;
+		}
+		mutex_unlock(&info->run_lock);
+	}
+
+	return result + _cas_poll_queue_bios(info);
+}
+
 void cas_stop_queue_thread(ocf_queue_t q)
 {
 	struct cas_thread_info *info = ocf_queue_get_priv(q);
@@ -12,8 +12,20 @@
 
 #define CAS_CPUS_ALL -1
 
+/*
+ * Polled bottom device bio, recorded on OCF queue so that cas_poll_queue_thread()
+ * can poll for its completion
+ */
+struct cas_polled_bio {
+	struct list_head list;
+	struct bio *bio;
+};
+
 int cas_create_queue_thread(ocf_queue_t q, int cpu);
 void cas_kick_queue_thread(ocf_queue_t q);
+int cas_poll_queue_thread(ocf_queue_t q);
+void cas_queue_add_polled_bio(ocf_queue_t q, struct cas_polled_bio *pb);
+void cas_queue_del_polled_bio(ocf_queue_t q, struct cas_polled_bio *pb);
 void cas_stop_queue_thread(ocf_queue_t q);
 
 int cas_create_cleaner_thread(ocf_cleaner_t c);
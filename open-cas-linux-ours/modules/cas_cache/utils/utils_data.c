@@ -32,16 +32,57 @@ static int get_starting_vec(struct bio_vec *vecs, uint64_t vecs_num,
 	return -1;
 }
 
-uint64_t cas_data_cpy(struct bio_vec *dst, uint64_t dst_num,
+extern u32 data_copy_nt_threshold;
+
+uint64_t cas_bvec_contig_len(const struct bio_vec *vecs, uint64_t vecs_num,
+		uint64_t idx, uint64_t max)
+{
+	const struct bio_vec *curr = &vecs[idx];
+	uint64_t len = curr->bv_len;
+	void *end = page_address(curr->bv_page) + curr->bv_offset + len;
+
+	for (idx++; idx < vecs_num && len < max; idx++) {
+		curr = &vecs[idx];
+		if (page_address(curr->bv_page) + curr->bv_offset != end)
+			break;
+
+		len += curr->bv_len;
+		end += curr->bv_len;
+	}
+
+	return len;
+}
+
+bool cas_data_cpy_use_nt(uint64_t bytes)
+{
+	return data_copy_nt_threshold && bytes >= data_copy_nt_threshold;
+}
+
+/*
+ * Moves position (vec index and byte offset within it) by given number of
+ * bytes. Returns false when end of vector array was reached.
+ */
+static bool cas_bvec_advance(const struct bio_vec *vecs, uint64_t vecs_num,
+		uint64_t *idx, uint64_t *offset, uint64_t bytes)
+{
+	*offset += bytes;
+
+	while (*idx < vecs_num && *offset >= vecs[*idx].bv_len) {
+		*offset -= vecs[*idx].bv_len;
+		(*idx)++;
+	}
+
+	return *idx < vecs_num;
+}
+
+static uint64_t __cas_data_cpy(struct bio_vec *dst, uint64_t dst_num,
 		struct bio_vec *src, uint64_t src_num,
-		uint64_t to, uint64_t from, uint64_t bytes)
+		uint64_t to, uint64_t from, uint64_t bytes, bool nt)
 {
 	uint64_t i, j, dst_len, src_len, to_copy;
-	uint64_t dst_off, src_off;
 	uint64_t written = 0;
 	int ret;
 	void *dst_p, *src_p;
-	struct bio_vec *curr_dst, *curr_src;
 
 	/* Locate vec idx and offset in dst vec array */
 	ret = get_starting_vec(dst, dst_num, to, &to);
@@ -61,70 +102,142 @@ uint64_t cas_data_cpy(struct bio_vec *dst, uint64_t dst_num,
 	}
 	i = ret;
 
-	curr_dst = &dst[j];
-	curr_src = &src[i];
-
-	dst_off = curr_dst->bv_offset + to;
-	dst_len = curr_dst->bv_len - to;
-
-	src_off = curr_src->bv_offset + from;
-	src_len = curr_src->bv_len - from;
-
 	while (written < bytes) {
-		dst_p = page_address(curr_dst->bv_page) + dst_off;
-		src_p = page_address(curr_src->bv_page) + src_off;
+		/* Copy whole physically contiguous runs at once */
+		dst_len = cas_bvec_contig_len(dst, dst_num, j,
+				to + bytes - written) - to;
+		src_len = cas_bvec_contig_len(src, src_num, i,
+				from + bytes - written) - from;
 
-		to_copy = src_len > dst_len ? dst_len : src_len;
+		to_copy = min3(dst_len, src_len, bytes - written);
 
-		/* Prevent from copying too much*/
-		if ((written + to_copy) > bytes)
-			to_copy = bytes - written;
+		dst_p = page_address(dst[j].bv_page) + dst[j].bv_offset + to;
+		src_p = page_address(src[i].bv_page) + src[i].bv_offset + from;
 
-		memcpy(dst_p, src_p, to_copy);
+		cas_data_memcpy(dst_p, src_p, to_copy, nt);
 		written += to_copy;
 
 		if (written == bytes)
 			break;
 
-		/* Setup new len and offset. */
-		dst_off += to_copy;
-		dst_len -= to_copy;
+		if (!cas_bvec_advance(src, src_num, &i, &from, to_copy))
+			break;
 
-		src_off += to_copy;
-		src_len -= to_copy;
+		if (!cas_bvec_advance(dst, dst_num, &j, &to, to_copy))
+			break;
+	}
 
-		/* Go to next src buffer */
-		if (src_len == 0) {
-			i++;
+	/* Order non-temporal stores before data is handed over */
+	if (nt)
+		wmb();
 
-			/* Setup new len and offset. */
-			if (i < src_num) {
-				curr_src = &src[i];
-				src_off = curr_src->bv_offset;
-				src_len = curr_src->bv_len;
-			} else {
-				break;
-			}
-		}
+	if (written != bytes) {
+		CAS_PRINT_RL(KERN_INFO "Written bytes not equal requested bytes "
+			"(written=%llu; requested=%llu)", written, bytes);
+	}
 
-		/* Go to next dst buffer */
-		if (dst_len == 0) {
-			j++;
+	return written;
+}
+
+uint64_t cas_data_cpy(struct bio_vec *dst, uint64_t dst_num,
+		struct bio_vec *src, uint64_t src_num,
+		uint64_t to, uint64_t from, uint64_t bytes)
+{
+	return __cas_data_cpy(dst, dst_num, src, src_num, to, from, bytes,
+			cas_data_cpy_use_nt(bytes));
+}
+
+#ifdef CAS_DATA_CPY_SELFTEST
+
+#include <linux/random.h>
+
+#define CAS_DATA_CPY_SELFTEST_PAGES 256
+#define CAS_DATA_CPY_SELFTEST_LOOPS 64
+
+static int cas_data_cpy_selftest_verify(struct blk_data *dst,
+		struct blk_data *src, uint64_t bytes)
+{
+	uint64_t i = 0, j = 0, from = 0, to = 0, off = 0, len;
+	void *dst_p, *src_p;
+
+	while (off < bytes) {
+		len = min3(src->vec[i].bv_len - from,
+				dst->vec[j].bv_len - to, bytes - off);
+
+		dst_p = page_address(dst->vec[j].bv_page) +
+				dst->vec[j].bv_offset + to;
+		src_p = page_address(src->vec[i].bv_page) +
+				src->vec[i].bv_offset + from;
+
+		if (memcmp(dst_p, src_p, len))
+			return -EIO;
 
-			if (j < dst_num) {
-				curr_dst = &dst[j];
-				dst_off = curr_dst->bv_offset;
-				dst_len = curr_dst->bv_len;
-			} else {
-				break;
+		off += len;
+		cas_bvec_advance(src->vec, src->size, &i, &from, len);
+		cas_bvec_advance(dst->vec, dst->size, &j, &to, len);
+	}
+
+	return 0;
+}
+
+int cas_data_cpy_selftest(void)
+{
+	static const uint64_t sizes[] = { 4 * KiB, 64 * KiB,
+		CAS_DATA_CPY_SELFTEST_PAGES * PAGE_SIZE };
+	struct blk_data *src, *dst;
+	uint64_t t_reg, t_nt, start;
+	int i, loop, nt, result = 0;
+
+	src = cas_ctx_data_alloc(CAS_DATA_CPY_SELFTEST_PAGES);
+	dst = cas_ctx_data_alloc(CAS_DATA_CPY_SELFTEST_PAGES);
+	if (!src || !dst) {
+		result = -ENOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < src->size; i++) {
+		get_random_bytes(page_address(src->vec[i].bv_page),
+				src->vec[i].bv_len);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		for (nt = 0; nt < 2; nt++) {
+			cas_ctx_data_secure_erase(dst);
+
+			start = ktime_get_ns();
+			for (loop = 0; loop < CAS_DATA_CPY_SELFTEST_LOOPS;
+					loop++) {
+				__cas_data_cpy(dst->vec, dst->size, src->vec,
+						src->size, 0, 0, sizes[i], nt);
 			}
+			if (nt)
+				t_nt = ktime_get_ns() - start;
+			else
+				t_reg = ktime_get_ns() - start;
+
+			result = cas_data_cpy_selftest_verify(dst, src,
+					sizes[i]);
+			if (result)
+				goto out;
 		}
+
+		printk(KERN_INFO OCF_PREFIX_SHORT "data copy %llu KiB: "
+				"regular %llu ns, non-temporal %llu ns\n",
+				sizes[i] / KiB,
+				t_reg / CAS_DATA_CPY_SELFTEST_LOOPS,
+				t_nt / CAS_DATA_CPY_SELFTEST_LOOPS);
 	}
 
-	if (written != bytes) {
-		CAS_PRINT_RL(KERN_INFO "Written bytes not equal requested bytes "
-			"(written=%llu; requested=%llu)", written, bytes);
+out:
+	cas_ctx_data_free(dst);
+	cas_ctx_data_free(src);
+
+	if (result) {
+		printk(KERN_ERR OCF_PREFIX_SHORT
+				"data copy selftest failed (%d)\n", result);
 	}
 
-	return written;
+	return result;
 }
+
+#endif
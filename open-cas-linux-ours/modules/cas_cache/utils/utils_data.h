@@ -28,4 +28,46 @@ uint64_t cas_data_cpy(struct bio_vec *dst, uint64_t dst_num,
 		struct bio_vec *src, uint64_t src_num,
 		uint64_t to, uint64_t from, uint64_t bytes);
 
+/**
+ * @brief Get length of virtually contiguous memory described by IO vector
+ *
+ * Adjacent vecs whose memory directly follows the previous one (e.g. pages
+ * which page allocator handed out in sequence) are merged, so they can be
+ * copied with single memcpy.
+ *
+ * @param vecs IO vector array
+ * @param vecs_num size of IO vector array
+ * @param idx index of vec where contiguous run starts
+ * @param max number of bytes caller needs, scan stops once run covers it
+ *
+ * @return number of contiguous bytes starting at beginning of vecs[idx],
+ *	vecs past the point where max bytes are covered are not inspected
+ */
+uint64_t cas_bvec_contig_len(const struct bio_vec *vecs, uint64_t vecs_num,
+		uint64_t idx, uint64_t max);
+
+/**
+ * @brief Check if copy of given size should bypass CPU caches
+ *
+ * Large copies (backfill copies, cleaner buffers) are not read back by CPU
+ * soon, so non-temporal stores keep them from evicting hot data from LLC.
+ */
+bool cas_data_cpy_use_nt(uint64_t bytes);
+
+static inline void cas_data_memcpy(void *dst, const void *src, size_t len,
+		bool nt)
+{
+	if (nt)
+		cas_memcpy_nt(dst, src, len);
+	else
+		memcpy(dst, src, len);
+}
+
+#ifdef CAS_DATA_CPY_SELFTEST
+/**
+ * @brief Verify copy engine and print regular vs non-temporal copy timings
+ */
+int cas_data_cpy_selftest(void);
+#endif
+
 #endif /* UTILS_DATA_H_ */
@@ -24,6 +24,9 @@ struct env_mpool {
 
 	int flags;
 		/*!< Allocation flags */
+
+	bool zero;
+		/*!< Should allocated items be zeroed */
 };
 
 struct env_mpool *env_mpool_create(uint32_t hdr_size, uint32_t elem_size,
@@ -46,6 +49,7 @@ struct env_mpool *env_mpool_create(uint32_t hdr_size, uint32_t elem_size,
 	mpool->mpool_max = mpool_max;
 	mpool->hdr_size = hdr_size;
 	mpool->elem_size = elem_size;
+	mpool->zero = zero;
 
 	for (i = 0; i < min(env_mpool_max, mpool_max + 1); i++) {
 		result = snprintf(name, sizeof(name), "%s_%u", name_perfix,
@@ -56,7 +60,7 @@ struct env_mpool *env_mpool_create(uint32_t hdr_size, uint32_t elem_size,
 		size = hdr_size + (elem_size * (1 << i));
 
 		mpool->allocator[i] = env_allocator_create_extended(
-				size, name, limits ? limits[i] : -1);
+				size, name, limits ? limits[i] : -1, zero);
 
 		if (!mpool->allocator[i])
 			goto err;
@@ -112,8 +116,8 @@ void *env_mpool_new_f(struct env_mpool *mpool, uint32_t count, int flags)
 	if (allocator) {
 		items = env_allocator_new(allocator);
 	} else if(mpool->fallback) {
-		items = cas_vmalloc(size,
-			flags | __GFP_ZERO | __GFP_HIGHMEM);
+		items = cas_vmalloc(size, flags | __GFP_HIGHMEM |
+				(mpool->zero ? __GFP_ZERO : 0));
 	}
 
 #ifdef ZERO_OR_NULL_PTR
@@ -19,6 +19,9 @@ enum {
 	env_mpool_32,
 	env_mpool_64,
 	env_mpool_128,
+	env_mpool_256,
+	env_mpool_512,
+	env_mpool_1024,
 
 	env_mpool_max
 };
@@ -37,7 +40,7 @@ struct env_mpool;
  * 		order or NULL if defaults are to be used. Array should have
  * 		mpool_max elements
  * @param name_prefix Format name prefix
- * @param zero Unused parameter
+ * @param zero Should allocated items be zeroed
  *
  * @return CAS memory pool
  */
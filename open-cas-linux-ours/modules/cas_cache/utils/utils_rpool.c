@@ -25,23 +25,47 @@
 #define CAS_DEBUG_PARAM(format, ...)
 #endif
 
-/* This is currently 24B padded/force aligned to 32B.
- * With a 64B cacheline this means two structs on different cores may
- * invalidate each other. This shouldn't happen between different physical
- * CPUs and cause false sharing though, since with an even number of cores
- * per CPU same cacheline shouldn't be polluted from the other physical CPU.
+struct cas_rpool_kobj;
+
+/* Per CPU pool is aligned to a full cacheline, so that pools of different
+ * CPUs never share one and do not invalidate each other on get/put.
  * */
 struct _cas_reserve_pool_per_cpu {
 	spinlock_t lock;
 	struct list_head list;
 	atomic_t count;
-} __attribute__((__aligned__(32)));
+
+	/* Number of items pool is refilled up to, adjusted to demand */
+	uint32_t target;
+
+	/* Lowest number of items in pool since last shrink */
+	uint32_t low_water;
+
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t refilled;
+	uint64_t shrunk;
+
+	struct work_struct refill_ws;
+	struct cas_reserve_pool *rpool_master;
+	int cpu;
+} __attribute__((__aligned__(64)));
 
 struct cas_reserve_pool {
 	uint32_t limit;
+	uint32_t min_target;
 	uint32_t entry_size;
 	char *name;
 	struct _cas_reserve_pool_per_cpu *rpools;
+
+	cas_rpool_new rpool_new;
+	cas_rpool_del rpool_del;
+	void *allocator_ctx;
+
+	/* Item on list of all reserve pools, walked by shrinker */
+	struct list_head list;
+
+	struct cas_rpool_kobj *kobj;
 };
 
 struct _cas_rpool_pre_alloc_info {
@@ -61,6 +85,15 @@ struct _cas_rpool_pre_alloc_info {
 		(struct list_head *)((unsigned long)entry + rpool->entry_size \
 				- sizeof(struct list_head))
 
+/* Pool starts with 1/CAS_RPOOL_MIN_TARGET_SHIFT of its limit and never
+ * shrinks below it */
+#define CAS_RPOOL_MIN_TARGET_SHIFT 3
+
+static LIST_HEAD(cas_rpools);
+static DEFINE_MUTEX(cas_rpools_lock);
+static struct shrinker *cas_rpools_shrinker;
+static struct kset *cas_rpools_kset;
+
 void _cas_rpool_pre_alloc_do(struct work_struct *ws)
 {
 	struct _cas_rpool_pre_alloc_info *info =
@@ -76,7 +109,7 @@ void _cas_rpool_pre_alloc_do(struct work_struct *ws)
 	cpu = smp_processor_id();
 	current_rpool = &rpool_master->rpools[cpu];
 
-	for (i = 0; i < rpool_master->limit; i++) {
+	for (i = 0; i < current_rpool->target; i++) {
 		entry = info->rpool_new(info->allocator_ctx, cpu);
 		if (!entry) {
 			info->error = -ENOMEM;
@@ -88,6 +121,8 @@ void _cas_rpool_pre_alloc_do(struct work_struct *ws)
 		atomic_inc(&current_rpool->count);
 	}
 
+	current_rpool->low_water = current_rpool->target;
+
 	CAS_DEBUG_PARAM("Added [%d] pre allocated items to reserve poll [%s]"
 			" for cpu %d", atomic_read(&current_rpool->count),
 			rpool_master->name, cpu);
@@ -108,6 +143,305 @@ int _cas_rpool_pre_alloc_schedule(int cpu,
 	return info->error;
 }
 
+/*
+ * Refills per CPU pool up to its target in background, so that allocations
+ * following a burst are served from pool instead of falling back to
+ * allocator in I/O path
+ */
+static void _cas_rpool_refill_do(struct work_struct *ws)
+{
+	struct _cas_reserve_pool_per_cpu *current_rpool = container_of(ws,
+			struct _cas_reserve_pool_per_cpu, refill_ws);
+	struct cas_reserve_pool *rpool_master = current_rpool->rpool_master;
+	struct list_head *item;
+	unsigned long flags;
+	void *entry;
+	bool added;
+
+	while (atomic_read(&current_rpool->count) <
+			READ_ONCE(current_rpool->target)) {
+		entry = rpool_master->rpool_new(rpool_master->allocator_ctx,
+				current_rpool->cpu);
+		if (!entry)
+			break;
+
+		spin_lock_irqsave(&current_rpool->lock, flags);
+		added = atomic_read(&current_rpool->count) <
+				rpool_master->limit;
+		if (added) {
+			item = RPOOL_ENTRY_TO_ITEM(rpool_master, entry);
+			list_add_tail(item, &current_rpool->list);
+			atomic_inc(&current_rpool->count);
+			current_rpool->refilled++;
+		}
+		spin_unlock_irqrestore(&current_rpool->lock, flags);
+
+		if (!added) {
+			rpool_master->rpool_del(rpool_master->allocator_ctx,
+					entry);
+			break;
+		}
+	}
+}
+
+/* *** SYSFS *** */
+
+struct cas_rpool_kobj {
+	struct kobject kobj;
+	struct cas_reserve_pool *rpool_master;
+};
+
+struct cas_rpool_attribute {
+	struct attribute attr;
+	ssize_t (*show)(struct cas_reserve_pool *rpool_master, char *page);
+};
+
+static ssize_t _cas_rpool_sysfs_show(struct kobject *kobj,
+		struct attribute *attr, char *page)
+{
+	struct cas_rpool_kobj *rpool_kobj =
+			container_of(kobj, struct cas_rpool_kobj, kobj);
+	struct cas_rpool_attribute *rpool_attr =
+			container_of(attr, struct cas_rpool_attribute, attr);
+
+	return rpool_attr->show(rpool_kobj->rpool_master, page);
+}
+
+static const struct sysfs_ops cas_rpool_sysfs_ops = {
+	.show = _cas_rpool_sysfs_show,
+};
+
+static ssize_t _cas_rpool_stats_show(struct cas_reserve_pool *rpool_master,
+		char *page)
+{
+	struct _cas_reserve_pool_per_cpu *current_rpool;
+	int i, cpu_no = num_online_cpus();
+	unsigned long flags;
+	uint64_t hits, misses, refilled, shrunk;
+	uint32_t count, target, low_water;
+	ssize_t size;
+
+	size = scnprintf(page, PAGE_SIZE, "limit %u min %u entry_size %u\n"
+			"cpu items target low_water hits misses hit_rate "
+			"refilled shrunk\n", rpool_master->limit,
+			rpool_master->min_target, rpool_master->entry_size);
+
+	for (i = 0; i < cpu_no; i++) {
+		current_rpool = &rpool_master->rpools[i];
+
+		spin_lock_irqsave(&current_rpool->lock, flags);
+		count = atomic_read(&current_rpool->count);
+		target = current_rpool->target;
+		low_water = current_rpool->low_water;
+		hits = current_rpool->hits;
+		misses = current_rpool->misses;
+		refilled = current_rpool->refilled;
+		shrunk = current_rpool->shrunk;
+		spin_unlock_irqrestore(&current_rpool->lock, flags);
+
+		size += scnprintf(page + size, PAGE_SIZE - size,
+				"%d %u %u %u %llu %llu %llu%% %llu %llu\n",
+				i, count, target, low_water, hits, misses,
+				hits + misses ?
+					div64_u64(hits * 100, hits + misses) :
+					100ULL,
+				refilled, shrunk);
+	}
+
+	return size;
+}
+
+static struct cas_rpool_attribute cas_rpool_stats_attr = {
+	.attr = { .name = "stats", .mode = S_IRUSR | S_IRGRP },
+	.show = _cas_rpool_stats_show,
+};
+
+static void _cas_rpool_kobj_release(struct kobject *kobj)
+{
+	kfree(container_of(kobj, struct cas_rpool_kobj, kobj));
+}
+
+static struct kobj_type cas_rpool_ktype = {
+	.release = _cas_rpool_kobj_release,
+	.sysfs_ops = &cas_rpool_sysfs_ops,
+};
+
+/*
+ * Pools are exposed by name, so anonymous pools and pools with duplicated
+ * names are not visible in sysfs
+ */
+static void _cas_rpool_sysfs_add(struct cas_reserve_pool *rpool_master)
+{
+	struct cas_rpool_kobj *rpool_kobj;
+	struct kobject *kobj;
+
+	if (!cas_rpools_kset || !rpool_master->name)
+		return;
+
+	kobj = kset_find_obj(cas_rpools_kset, rpool_master->name);
+	if (kobj) {
+		kobject_put(kobj);
+		return;
+	}
+
+	rpool_kobj = kzalloc(sizeof(*rpool_kobj), GFP_KERNEL);
+	if (!rpool_kobj)
+		return;
+
+	rpool_kobj->rpool_master = rpool_master;
+	rpool_kobj->kobj.kset = cas_rpools_kset;
+	kobject_init(&rpool_kobj->kobj, &cas_rpool_ktype);
+
+	if (kobject_add(&rpool_kobj->kobj, NULL, "%s", rpool_master->name) ||
+			sysfs_create_file(&rpool_kobj->kobj,
+					&cas_rpool_stats_attr.attr)) {
+		printk(KERN_WARNING "Cannot register reserve pool [%s] "
+				"in sysfs\n", rpool_master->name);
+		kobject_put(&rpool_kobj->kobj);
+		return;
+	}
+
+	rpool_master->kobj = rpool_kobj;
+}
+
+static void _cas_rpool_sysfs_del(struct cas_reserve_pool *rpool_master)
+{
+	if (!rpool_master->kobj)
+		return;
+
+	/* Waits for pending reads of stats, pool may be freed afterwards */
+	kobject_del(&rpool_master->kobj->kobj);
+	kobject_put(&rpool_master->kobj->kobj);
+	rpool_master->kobj = NULL;
+}
+
+/* *** SHRINKER *** */
+
+static unsigned long _cas_rpool_shrink_count(struct shrinker *shrinker,
+		struct shrink_control *sc)
+{
+	struct cas_reserve_pool *rpool_master;
+	unsigned long freeable = 0;
+	int i, cpu_no = num_online_cpus();
+	uint32_t count;
+
+	if (!mutex_trylock(&cas_rpools_lock))
+		return 0;
+
+	list_for_each_entry(rpool_master, &cas_rpools, list) {
+		for (i = 0; i < cpu_no; i++) {
+			count = atomic_read(&rpool_master->rpools[i].count);
+			if (count > rpool_master->min_target)
+				freeable += count - rpool_master->min_target;
+		}
+	}
+
+	mutex_unlock(&cas_rpools_lock);
+
+	return freeable;
+}
+
+/*
+ * Items which stayed in pool since last shrink (low water mark) are released
+ * first, if there are none pool is cut in half. Either way target is lowered
+ * so that refill does not bring released memory back.
+ */
+static unsigned long _cas_rpool_shrink_cpu(struct cas_reserve_pool *rpool_master,
+		struct _cas_reserve_pool_per_cpu *current_rpool,
+		unsigned long nr_to_scan)
+{
+	struct list_head *item, *next;
+	unsigned long flags, freed = 0;
+	uint32_t count, keep;
+	LIST_HEAD(release);
+
+	spin_lock_irqsave(&current_rpool->lock, flags);
+
+	count = atomic_read(&current_rpool->count);
+	keep = current_rpool->target > current_rpool->low_water ?
+			current_rpool->target - current_rpool->low_water : 0;
+	if (keep >= count)
+		keep = count / 2;
+	keep = max(keep, rpool_master->min_target);
+	if (count > keep && count - keep > nr_to_scan)
+		keep = count - nr_to_scan;
+
+	current_rpool->target = keep;
+
+	while (atomic_read(&current_rpool->count) > keep) {
+		item = current_rpool->list.next;
+		list_move(item, &release);
+		atomic_dec(&current_rpool->count);
+		current_rpool->shrunk++;
+		freed++;
+	}
+
+	current_rpool->low_water = atomic_read(&current_rpool->count);
+
+	spin_unlock_irqrestore(&current_rpool->lock, flags);
+
+	list_for_each_safe(item, next, &release) {
+		list_del(item);
+		rpool_master->rpool_del(rpool_master->allocator_ctx,
+				RPOOL_ITEM_TO_ENTRY(rpool_master, item));
+	}
+
+	return freed;
+}
+
+static unsigned long _cas_rpool_shrink_scan(struct shrinker *shrinker,
+		struct shrink_control *sc)
+{
+	struct cas_reserve_pool *rpool_master;
+	unsigned long freed = 0;
+	int i, cpu_no = num_online_cpus();
+
+	if (!mutex_trylock(&cas_rpools_lock))
+		return SHRINK_STOP;
+
+	list_for_each_entry(rpool_master, &cas_rpools, list) {
+		for (i = 0; i < cpu_no && freed < sc->nr_to_scan; i++) {
+			freed += _cas_rpool_shrink_cpu(rpool_master,
+					&rpool_master->rpools[i],
+					sc->nr_to_scan - freed);
+		}
+	}
+
+	/* Start from another pool next time */
+	list_rotate_left(&cas_rpools);
+
+	mutex_unlock(&cas_rpools_lock);
+
+	return freed;
+}
+
+int cas_rpool_init(void)
+{
+	cas_rpools_kset = kset_create_and_add("reserve_pools", NULL,
+			&THIS_MODULE->mkobj.kobj);
+	if (!cas_rpools_kset)
+		return -ENOMEM;
+
+	cas_rpools_shrinker = cas_shrinker_create(_cas_rpool_shrink_count,
+			_cas_rpool_shrink_scan, "cas-rpool");
+	if (!cas_rpools_shrinker) {
+		kset_unregister(cas_rpools_kset);
+		cas_rpools_kset = NULL;
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+void cas_rpool_deinit(void)
+{
+	cas_shrinker_destroy(cas_rpools_shrinker);
+	cas_rpools_shrinker = NULL;
+
+	kset_unregister(cas_rpools_kset);
+	cas_rpools_kset = NULL;
+}
+
 void cas_rpool_destroy(struct cas_reserve_pool *rpool_master,
 		cas_rpool_del rpool_del, void *allocator_ctx)
 {
@@ -126,9 +460,18 @@ void cas_rpool_destroy(struct cas_reserve_pool *rpool_master,
 		return;
 	}
 
+	mutex_lock(&cas_rpools_lock);
+	list_del_init(&rpool_master->list);
+	mutex_unlock(&cas_rpools_lock);
+
+	_cas_rpool_sysfs_del(rpool_master);
+
 	for (i = 0; i < cpu_no; i++) {
 		current_rpool = &rpool_master->rpools[i];
 
+		if (current_rpool->rpool_master)
+			cancel_work_sync(&current_rpool->refill_ws);
+
 		CAS_DEBUG_PARAM("Destroyed reserve poll [%s] for cpu %d",
 				rpool_master->name, i);
 
@@ -170,14 +513,22 @@ struct cas_reserve_pool *cas_rpool_create(uint32_t limit, char *name,
 	if (!rpool_master)
 		goto error;
 
+	INIT_LIST_HEAD(&rpool_master->list);
+
 	rpool_master->rpools = kzalloc(sizeof(*rpool_master->rpools) * cpu_no,
 			GFP_KERNEL);
 	if (!rpool_master->rpools)
 		goto error;
 
 	rpool_master->limit = limit;
+	rpool_master->min_target = max_t(uint32_t, 1,
+			limit >> CAS_RPOOL_MIN_TARGET_SHIFT);
+	rpool_master->min_target = min(rpool_master->min_target, limit);
 	rpool_master->name = name;
 	rpool_master->entry_size = entry_size;
+	rpool_master->rpool_new = rpool_new;
+	rpool_master->rpool_del = rpool_del;
+	rpool_master->allocator_ctx = allocator_ctx;
 
 	info.rpool_master = rpool_master;
 	info.rpool_new = rpool_new;
@@ -187,6 +538,10 @@ struct cas_reserve_pool *cas_rpool_create(uint32_t limit, char *name,
 		current_rpool = &rpool_master->rpools[i];
 		spin_lock_init(&current_rpool->lock);
 		INIT_LIST_HEAD(&current_rpool->list);
+		INIT_WORK(&current_rpool->refill_ws, _cas_rpool_refill_do);
+		current_rpool->rpool_master = rpool_master;
+		current_rpool->cpu = i;
+		current_rpool->target = rpool_master->min_target;
 
 		if (_cas_rpool_pre_alloc_schedule(i, &info))
 			goto error;
@@ -195,6 +550,12 @@ struct cas_reserve_pool *cas_rpool_create(uint32_t limit, char *name,
 				rpool_master->name, i);
 	}
 
+	_cas_rpool_sysfs_add(rpool_master);
+
+	mutex_lock(&cas_rpools_lock);
+	list_add_tail(&rpool_master->list, &cas_rpools);
+	mutex_unlock(&cas_rpools_lock);
+
 	return rpool_master;
 error:
 
@@ -210,6 +571,8 @@ void *cas_rpool_try_get(struct cas_reserve_pool *rpool_master, int *cpu)
 	struct _cas_reserve_pool_per_cpu *current_rpool = NULL;
 	struct list_head *item = NULL;
 	void *entry = NULL;
+	uint32_t count;
+	bool refill;
 
 	CAS_DEBUG_TRACE();
 
@@ -223,10 +586,26 @@ void *cas_rpool_try_get(struct cas_reserve_pool *rpool_master, int *cpu)
 		entry = RPOOL_ITEM_TO_ENTRY(rpool_master, item);
 		list_del(item);
 		atomic_dec(&current_rpool->count);
+		current_rpool->hits++;
+	} else {
+		/* Pool was too small for this burst, grow it */
+		current_rpool->misses++;
+		current_rpool->target = min(current_rpool->target * 2,
+				rpool_master->limit);
 	}
 
+	count = atomic_read(&current_rpool->count);
+	if (count < current_rpool->low_water)
+		current_rpool->low_water = count;
+
+	/* Refill ahead of demand once half of the pool is used */
+	refill = count < current_rpool->target / 2 || !entry;
+
 	spin_unlock_irqrestore(&current_rpool->lock, flags);
 
+	if (refill)
+		schedule_work(&current_rpool->refill_ws);
+
 	CAS_DEBUG_PARAM("[%s]Removed item from reserve pool [%s] for cpu [%d], "
 				"items in pool %d", rpool_master->name,
 				item == NULL ? "SKIPPED" : "OK", *cpu,
@@ -248,7 +627,7 @@ int cas_rpool_try_put(struct cas_reserve_pool *rpool_master, void *entry, int cp
 
 	spin_lock_irqsave(&current_rpool->lock, flags);
 
-	if (atomic_read(&current_rpool->count) >= rpool_master->limit) {
+	if (atomic_read(&current_rpool->count) >= current_rpool->target) {
 		ret = 1;
 		goto error;
 	}
@@ -13,6 +13,10 @@ struct cas_reserve_pool;
 typedef void (*cas_rpool_del)(void *allocator_ctx, void *item);
 typedef void *(*cas_rpool_new)(void *allocator_ctx, int cpu);
 
+int cas_rpool_init(void);
+
+void cas_rpool_deinit(void);
+
 struct cas_reserve_pool *cas_rpool_create(uint32_t limit, char *name,
 		uint32_t item_size, cas_rpool_new rpool_new,
 		cas_rpool_del rpool_del, void *allocator_ctx);
@@ -10,6 +10,7 @@
 #include "vol_block_dev_top.h"
 
 struct casdsk_disk;
+struct blkdev_defer_queue;
 
 struct bd_object {
 	struct casdsk_disk *dsk;
@@ -25,6 +26,9 @@ struct bd_object {
 	uint32_t opened_by_bdev : 1;
 		/*!< Opened by supplying bdev manually */
 
+	uint32_t expobj_blk_mq : 1;
+		/*!< Exported object uses native blk-mq request path */
+
 	atomic64_t pending_rqs;
 		/*!< This fields describes in flight IO requests */
 
@@ -34,6 +38,9 @@ struct bd_object {
 	struct workqueue_struct *expobj_wq;
 		/*< Workqueue for I/O handled by top vol */
 
+	struct blkdev_defer_queue __percpu *defer_queues;
+		/*< Per-CPU lists of bios deferred to expobj_wq */
+
 	ocf_volume_t front_volume;
 		/*< Cache/core front volume */
 };
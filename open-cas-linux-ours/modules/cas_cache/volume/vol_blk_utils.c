@@ -4,6 +4,7 @@
 */
 
 #include "vol_blk_utils.h"
+#include "../utils/utils_data.h"
 
 static void cas_io_iter_advanced(struct bio_vec_iter *iter, uint32_t bytes)
 {
@@ -30,42 +31,62 @@ static void cas_io_iter_advanced(struct bio_vec_iter *iter, uint32_t bytes)
 	}
 }
 
+/*
+ * Number of virtually contiguous bytes from current iterator position,
+ * including following vecs which directly continue the current one. Scan
+ * stops once @bytes are covered.
+ */
+static uint32_t cas_io_iter_contig_len(struct bio_vec_iter *iter,
+		uint32_t bytes)
+{
+	uint32_t skip = iter->offset - iter->ivec->bv_offset;
+
+	return cas_bvec_contig_len(iter->vec, iter->vec_size, iter->idx,
+			skip + bytes) - skip;
+}
+
 uint32_t cas_io_iter_cpy(struct bio_vec_iter *dst, struct bio_vec_iter *src,
 		uint32_t bytes)
 {
 	uint32_t to_copy, written = 0;
 	void *adst, *asrc;
+	bool nt = cas_data_cpy_use_nt(bytes);
 
 	if (dst->idx >= dst->vec_size)
 		return 0;
 
-	BUG_ON(dst->offset + dst->len > PAGE_SIZE);
+	BUG_ON(dst->offset + dst->len > CAS_DATA_CHUNK_SIZE_MAX);
 
 	if (src->idx >= src->vec_size)
 		return 0;
 
-	BUG_ON(src->offset + src->len > PAGE_SIZE);
+	BUG_ON(src->offset + src->len > CAS_DATA_CHUNK_SIZE_MAX);
 
 	while (bytes) {
-		to_copy = min(dst->len, src->len);
-		to_copy = min(to_copy, bytes);
-		if (to_copy == 0) {
+		if (!dst->len || !src->len) {
 			/* No more bytes for coping */
 			break;
 		}
 
+		to_copy = min3(cas_io_iter_contig_len(dst, bytes),
+				cas_io_iter_contig_len(src, bytes), bytes);
+
 		adst = page_address(dst->ivec->bv_page) + dst->offset;
 		asrc = page_address(src->ivec->bv_page) + src->offset;
 
-		memcpy(adst, asrc, to_copy);
+		cas_data_memcpy(adst, asrc, to_copy, nt);
 
 		bytes -= to_copy;
 		written += to_copy;
 
-		cas_io_iter_advanced(dst, to_copy);
-		cas_io_iter_advanced(src, to_copy);
+		cas_io_iter_move(dst, to_copy);
+		cas_io_iter_move(src, to_copy);
 	}
 
+	/* Order non-temporal stores before data is handed over */
+	if (nt)
+		wmb();
+
 	return written;
 }
 
@@ -79,7 +100,7 @@ uint32_t cas_io_iter_cpy_from_data(struct bio_vec_iter *dst,
 	if (dst->idx >= dst->vec_size)
 		return 0;
 
-	BUG_ON(dst->offset + dst->len > PAGE_SIZE);
+	BUG_ON(dst->offset + dst->len > CAS_DATA_CHUNK_SIZE_MAX);
 
 	while (bytes) {
 		to_copy = min(dst->len, bytes);
@@ -113,7 +134,7 @@ uint32_t cas_io_iter_cpy_to_data(void *dst, struct bio_vec_iter *src,
 	if (src->idx >= src->vec_size)
 		return 0;
 
-	BUG_ON(src->offset + src->len > PAGE_SIZE);
+	BUG_ON(src->offset + src->len > CAS_DATA_CHUNK_SIZE_MAX);
 
 	while (bytes) {
 		to_copy = min(bytes, src->len);
@@ -143,7 +164,7 @@ uint32_t cas_io_iter_move(struct bio_vec_iter *iter, uint32_t bytes)
 	if (iter->idx >= iter->vec_size)
 		return 0;
 
-	BUG_ON(iter->offset + iter->len > PAGE_SIZE);
+	BUG_ON(iter->offset + iter->len > CAS_DATA_CHUNK_SIZE_MAX);
 
 	while (bytes) {
 		to_move = min(iter->len, bytes);
@@ -169,7 +190,7 @@ uint32_t cas_io_iter_zero(struct bio_vec_iter *dst, uint32_t bytes)
 	if (dst->idx >= dst->vec_size)
 		return 0;
 
-	BUG_ON(dst->offset + dst->len > PAGE_SIZE);
+	BUG_ON(dst->offset + dst->len > CAS_DATA_CHUNK_SIZE_MAX);
 
 	while (bytes) {
 		to_fill = min(dst->len, (typeof(dst->len))PAGE_SIZE);
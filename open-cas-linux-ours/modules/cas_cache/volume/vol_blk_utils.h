@@ -8,6 +8,7 @@
 
 #include "obj_blk.h"
 #include "context.h"
+#include "../threads.h"
 
 struct blkio {
 	int error;
@@ -17,6 +18,9 @@ struct blkio {
 
 	struct blk_data *data; /* IO data buffer */
 
+	/* Bio of this IO submitted with polled flag, if any */
+	struct cas_polled_bio polled;
+
 	/* BIO vector iterator for sending IO */
 	struct bio_vec_iter iter;
 };
@@ -193,6 +193,9 @@ CAS_DECLARE_BLOCK_CALLBACK(cas_bd_io_end, struct bio *bio,
 	if (err == -EOPNOTSUPP && (CAS_BIO_OP_FLAGS(bio) & CAS_BIO_DISCARD))
 		err = 0;
 
+	if (bdio->polled.bio == bio)
+		cas_queue_del_polled_bio(io->io_queue, &bdio->polled);
+
 	cas_bd_io_end(io, err);
 
 	bio_put(bio);
@@ -353,6 +356,25 @@ static inline bool cas_bd_io_prepare(int *dir, struct ocf_io *io)
 	return true;
 }
 
+/*
+ * Polled flag is passed to bottom device only for I/O on data of polled bio
+ * of exported object. Such I/O completes before that bio does, so poll_bio()
+ * of exported object keeps polling for it until then. Other I/O issued on
+ * behalf of polled request (e.g. backfill from copy of the data) may outlive
+ * it, and would never complete if submitted with polled flag.
+ */
+static inline bool block_dev_io_polled(struct ocf_io *io,
+		struct block_device *bd)
+{
+	struct blkio *bdio = cas_io_to_blkio(io);
+
+	if (!(io->flags & CAS_REQ_POLLED) || !bdio->data ||
+			!bdio->data->polled)
+		return false;
+
+	return CAS_CHECK_QUEUE_POLL(bdev_get_queue(bd));
+}
+
 /*
  *
  */
@@ -365,6 +387,7 @@ static void block_dev_submit_io(struct ocf_io *io)
 	uint32_t bytes = io->bytes;
 	int dir = io->dir;
 	struct blk_plug plug;
+	bool polled;
 
 	if (CAS_IS_SET_FLUSH(io->flags)) {
 		CAS_DEBUG_MSG("Flush request");
@@ -385,6 +408,9 @@ static void block_dev_submit_io(struct ocf_io *io)
 		return;
 	}
 
+	polled = block_dev_io_polled(io, bdobj->btm_bd);
+	bdio->polled.bio = NULL;
+
 	blk_start_plug(&plug);
 
 	while (cas_io_iter_is_next(iter) && bytes) {
@@ -403,7 +429,7 @@ static void block_dev_submit_io(struct ocf_io *io)
 		CAS_BIO_BISECTOR(bio) = addr / SECTOR_SIZE;
 		bio->bi_next = NULL;
 		bio->bi_private = io;
-		CAS_BIO_OP_FLAGS(bio) |= io->flags;
+		CAS_BIO_OP_FLAGS(bio) |= io->flags & ~CAS_REQ_POLLED;
 		bio->bi_end_io = CAS_REFER_BLOCK_CALLBACK(cas_bd_io_end);
 
 		/* Add pages */
@@ -439,6 +465,14 @@ static void block_dev_submit_io(struct ocf_io *io)
 			/* Increase IO reference for sending this IO */
 			atomic_inc(&bdio->rq_remaning);
 
+			/* Poll only for the last bio, others use interrupts */
+			if (polled && !bytes) {
+				CAS_BIO_OP_FLAGS(bio) |= CAS_REQ_POLLED;
+				bdio->polled.bio = bio;
+				cas_queue_add_polled_bio(io->io_queue,
+						&bdio->polled);
+			}
+
 			/* Send BIO */
 			CAS_DEBUG_MSG("Submit IO");
 			cas_submit_bio(dir, bio);
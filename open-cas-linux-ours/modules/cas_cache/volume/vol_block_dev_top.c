@@ -5,12 +5,14 @@
 
 #include "cas_cache.h"
 #include "utils/cas_err.h"
+#include "threads.h"
 
-static void blkdev_set_bio_data(struct blk_data *data, struct bio *bio)
+static uint32_t blkdev_set_bio_data(struct blk_data *data, struct bio *bio,
+		uint32_t i)
 {
 #if LINUX_VERSION_CODE < KERNEL_VERSION(3, 14, 0)
 	struct bio_vec *bvec;
-	uint32_t iter = 0, i = 0;
+	uint32_t iter = 0;
 
 	bio_for_each_segment(bvec, bio, iter) {
 		BUG_ON(i >= data->size);
@@ -20,7 +22,6 @@ static void blkdev_set_bio_data(struct blk_data *data, struct bio *bio)
 #else
 	struct bio_vec bvec;
 	struct bvec_iter iter;
-	uint32_t i = 0;
 
 	bio_for_each_segment(bvec, bio, iter) {
 		BUG_ON(i >= data->size);
@@ -28,6 +29,8 @@ static void blkdev_set_bio_data(struct blk_data *data, struct bio *bio)
 		i++;
 	}
 #endif
+
+	return i;
 }
 
 static inline int blkdev_can_hndl_bio(struct bio *bio)
@@ -155,41 +158,93 @@ static int blkdev_core_set_geometry(struct casdsk_disk *dsk, void *private)
 	return 0;
 }
 
-struct defer_bio_context {
+static void blkdev_handle_bio(struct bd_object *bvol, struct bio *bio);
+static void blkdev_handle_bio_noflush(struct bd_object *bvol, struct bio *bio);
+
+/*
+ * Bios which cannot be handled in interrupt context are linked through
+ * bi_next on per-CPU lists, so deferring needs no allocation. One work item
+ * per CPU drains everything deferred on that CPU.
+ */
+struct blkdev_defer_queue {
+	spinlock_t lock;
+	struct bio_list bios;
+		/*!< Bios to be handled from scratch */
+	struct bio_list noflush_bios;
+		/*!< Bios with preceding flush already completed */
 	struct work_struct io_work;
-	void (*cb)(struct bd_object *bvol, struct bio *bio);
 	struct bd_object *bvol;
-	struct bio *bio;
 };
 
 static void blkdev_defer_bio_work(struct work_struct *work)
 {
-	struct defer_bio_context *context;
+	struct blkdev_defer_queue *dq;
+	struct bio_list bios, noflush_bios;
+	struct bio *bio;
+	unsigned long flags;
+
+	dq = container_of(work, struct blkdev_defer_queue, io_work);
+
+	spin_lock_irqsave(&dq->lock, flags);
+	bios = dq->bios;
+	noflush_bios = dq->noflush_bios;
+	bio_list_init(&dq->bios);
+	bio_list_init(&dq->noflush_bios);
+	spin_unlock_irqrestore(&dq->lock, flags);
 
-	context = container_of(work, struct defer_bio_context, io_work);
-	context->cb(context->bvol, context->bio);
-	kfree(context);
+	while ((bio = bio_list_pop(&noflush_bios)))
+		blkdev_handle_bio_noflush(dq->bvol, bio);
+
+	while ((bio = bio_list_pop(&bios)))
+		blkdev_handle_bio(dq->bvol, bio);
 }
 
 static void blkdev_defer_bio(struct bd_object *bvol, struct bio *bio,
-		void (*cb)(struct bd_object *bvol, struct bio *bio))
+		bool noflush)
 {
-	struct defer_bio_context *context;
+	struct blkdev_defer_queue *dq;
+	unsigned long flags;
 
 	BUG_ON(!bvol->expobj_wq);
+	BUG_ON(!bvol->defer_queues);
 
-	context = kmalloc(sizeof(*context), GFP_ATOMIC);
-	if (!context) {
-		CAS_BIO_ENDIO(bio, CAS_BIO_BISIZE(bio),
-			CAS_ERRNO_TO_BLK_STS(-ENOMEM));
-		return;
+	dq = get_cpu_ptr(bvol->defer_queues);
+
+	spin_lock_irqsave(&dq->lock, flags);
+	bio_list_add(noflush ? &dq->noflush_bios : &dq->bios, bio);
+	spin_unlock_irqrestore(&dq->lock, flags);
+
+	/* No-op if drain is already pending */
+	queue_work(bvol->expobj_wq, &dq->io_work);
+
+	put_cpu_ptr(bvol->defer_queues);
+}
+
+static int blkdev_defer_queues_init(struct bd_object *bvol)
+{
+	struct blkdev_defer_queue *dq;
+	int cpu;
+
+	bvol->defer_queues = alloc_percpu(struct blkdev_defer_queue);
+	if (!bvol->defer_queues)
+		return -ENOMEM;
+
+	for_each_possible_cpu(cpu) {
+		dq = per_cpu_ptr(bvol->defer_queues, cpu);
+		spin_lock_init(&dq->lock);
+		bio_list_init(&dq->bios);
+		bio_list_init(&dq->noflush_bios);
+		INIT_WORK(&dq->io_work, blkdev_defer_bio_work);
+		dq->bvol = bvol;
 	}
 
-	context->cb = cb;
-	context->bio = bio;
-	context->bvol = bvol;
-	INIT_WORK(&context->io_work, blkdev_defer_bio_work);
-	queue_work(bvol->expobj_wq, &context->io_work);
+	return 0;
+}
+
+static void blkdev_defer_queues_deinit(struct bd_object *bvol)
+{
+	free_percpu(bvol->defer_queues);
+	bvol->defer_queues = NULL;
 }
 
 static void blkdev_complete_data_master(struct blk_data *master, int error)
@@ -237,7 +292,8 @@ static int blkdev_handle_data_single(struct bd_object *bvol, struct bio *bio,
 {
 	ocf_cache_t cache = ocf_volume_get_cache(bvol->front_volume);
 	struct cache_priv *cache_priv = ocf_cache_get_priv(cache);
-	ocf_queue_t queue = cache_priv->io_queues[smp_processor_id()];
+	unsigned int queue_idx = smp_processor_id();
+	ocf_queue_t queue = cache_priv->io_queues[queue_idx];
 	struct ocf_io *io;
 	struct blk_data *data;
 	uint64_t flags = CAS_BIO_OP_FLAGS(bio);
@@ -249,7 +305,7 @@ static int blkdev_handle_data_single(struct bd_object *bvol, struct bio *bio,
 		return -ENOMEM;
 	}
 
-	blkdev_set_bio_data(data, bio);
+	blkdev_set_bio_data(data, bio, 0);
 
 	io = ocf_volume_new_io(bvol->front_volume, queue,
 			CAS_BIO_BISECTOR(bio) << SECTOR_SHIFT,
@@ -280,6 +336,12 @@ static int blkdev_handle_data_single(struct bd_object *bvol, struct bio *bio,
 
 	atomic_inc(&master_ctx->data->master_remaining);
 
+	/* Tell blkdev_poll_bio() which OCF queue to process */
+	if (flags & CAS_REQ_POLLED) {
+		data->polled = true;
+		CAS_BIO_SET_POLL_COOKIE(master_ctx->bio, queue_idx);
+	}
+
 	ocf_io_set_cmpl(io, bio, master_ctx->data, blkdev_complete_data);
 
 	ocf_volume_submit_io(io);
@@ -392,7 +454,7 @@ static void blkdev_complete_flush(struct ocf_io *io, int error)
 	}
 
 	if (in_interrupt())
-		blkdev_defer_bio(bvol, bio, blkdev_handle_bio_noflush);
+		blkdev_defer_bio(bvol, bio, true);
 	else
 		blkdev_handle_bio_noflush(bvol, bio);
 }
@@ -435,11 +497,29 @@ static void blkdev_submit_bio(struct bd_object *bvol, struct bio *bio)
 	}
 
 	if (in_interrupt())
-		blkdev_defer_bio(bvol, bio, blkdev_handle_bio);
+		blkdev_defer_bio(bvol, bio, false);
 	else
 		blkdev_handle_bio(bvol, bio);
 }
 
+/*
+ * Polled completion - instead of waiting for queue thread wakeup, process
+ * requests of OCF queue which polled bio was submitted to and poll bottom
+ * devices for its I/O. Poll cookie holds index of that queue in io_queues,
+ * set by blkdev_handle_data_single().
+ */
+static int blkdev_poll_bio(struct bd_object *bvol, struct bio *bio)
+{
+	ocf_cache_t cache = ocf_volume_get_cache(bvol->front_volume);
+	struct cache_priv *cache_priv = ocf_cache_get_priv(cache);
+	unsigned int queue_idx = CAS_BIO_GET_POLL_COOKIE(bio);
+
+	if (queue_idx >= cache_priv->io_queues_no)
+		return 0;
+
+	return cas_poll_queue_thread(cache_priv->io_queues[queue_idx]);
+}
+
 static void blkdev_core_submit_bio(struct casdsk_disk *dsk,
 		struct bio *bio, void *private)
 {
@@ -453,9 +533,193 @@ static void blkdev_core_submit_bio(struct casdsk_disk *dsk,
 	blkdev_submit_bio(bvol, bio);
 }
 
+static int blkdev_core_poll_bio(struct casdsk_disk *dsk, struct bio *bio,
+		void *private)
+{
+	ocf_core_t core = private;
+
+	BUG_ON(!core);
+
+	return blkdev_poll_bio(bd_object(ocf_core_get_volume(core)), bio);
+}
+
 static struct casdsk_exp_obj_ops kcas_core_exp_obj_ops = {
 	.set_geometry = blkdev_core_set_geometry,
 	.submit_bio = blkdev_core_submit_bio,
+	.poll_bio = blkdev_core_poll_bio,
+};
+
+/*
+ * Number of bio_vec entries embedded in blk-mq request private data.
+ * Requests with more segments get vector allocated from cas_bvec_pool.
+ */
+#define BLKDEV_RQ_INLINE_VECS 32
+
+struct blkdev_rq_ctx {
+	/* Must be last, followed by BLKDEV_RQ_INLINE_VECS vectors */
+	struct blk_data data;
+};
+
+#define BLKDEV_RQ_PDU_SIZE (sizeof(struct blkdev_rq_ctx) + \
+		BLKDEV_RQ_INLINE_VECS * sizeof(struct bio_vec))
+
+static uint32_t blkdev_rq_segments(struct request *rq)
+{
+	struct bio *bio;
+	uint32_t segments = 0;
+
+	__rq_for_each_bio(bio, rq)
+		segments += bio_segments(bio);
+
+	return segments;
+}
+
+static void blkdev_set_rq_data(struct blk_data *data, struct request *rq)
+{
+	struct bio *bio;
+	uint32_t i = 0;
+
+	__rq_for_each_bio(bio, rq)
+		i = blkdev_set_bio_data(data, bio, i);
+}
+
+static void blkdev_complete_rq(struct ocf_io *io, int error)
+{
+	struct request *rq = io->priv1;
+	struct blk_data *data = io->priv2;
+	struct blkdev_rq_ctx *ctx = blk_mq_rq_to_pdu(rq);
+	int result = map_cas_err_to_generic(error);
+
+	ocf_io_put(io);
+	if (data != &ctx->data)
+		cas_free_blk_data(data);
+
+	CAS_END_REQUEST_ALL(rq, CAS_ERRNO_TO_BLK_STS(result));
+}
+
+static struct ocf_io *blkdev_rq_new_io(struct bd_object *bvol,
+		ocf_queue_t queue, struct request *rq, struct blk_data *data)
+{
+	ocf_cache_t cache = ocf_volume_get_cache(bvol->front_volume);
+	uint64_t flags;
+
+	if (CAS_RQ_IS_FLUSH(rq)) {
+		return ocf_volume_new_io(bvol->front_volume, queue, 0, 0,
+				OCF_WRITE, 0, CAS_SET_FLUSH(0));
+	}
+
+	if (CAS_RQ_IS_DISCARD(rq)) {
+		return ocf_volume_new_io(bvol->front_volume, queue,
+				blk_rq_pos(rq) << SECTOR_SHIFT,
+				blk_rq_bytes(rq), OCF_WRITE, 0, 0);
+	}
+
+	flags = CAS_BIO_OP_FLAGS(rq->bio);
+
+	return ocf_volume_new_io(bvol->front_volume, queue,
+			blk_rq_pos(rq) << SECTOR_SHIFT, blk_rq_bytes(rq),
+			(rq_data_dir(rq) == READ) ? OCF_READ : OCF_WRITE,
+			cas_cls_classify(cache, rq->bio), CAS_CLEAR_FLUSH(flags));
+}
+
+/*
+ * Native blk-mq request handler. Data vector lives in request private data
+ * allocated along with the tag, so common sized requests need no per I/O
+ * allocation besides OCF io. Requests are mapped to OCF queues by index of
+ * hardware context they were dispatched from, wrapping around if there are
+ * more hardware contexts than OCF queues.
+ *
+ * Allocation failures are reported as BLK_STS_RESOURCE, so that block layer
+ * requeues the request instead of failing it.
+ */
+static CAS_BLK_STATUS_T blkdev_queue_rq(struct bd_object *bvol,
+		struct request *rq, unsigned int hctx_idx)
+{
+	ocf_cache_t cache = ocf_volume_get_cache(bvol->front_volume);
+	struct cache_priv *cache_priv = ocf_cache_get_priv(cache);
+	ocf_queue_t queue;
+	struct blkdev_rq_ctx *ctx = blk_mq_rq_to_pdu(rq);
+	struct blk_data *data = &ctx->data;
+	struct ocf_io *io;
+	uint32_t segments = 0;
+	int ret;
+
+	queue = cache_priv->io_queues[hctx_idx % cache_priv->io_queues_no];
+
+	memset(data, 0, sizeof(*data));
+
+	if (!CAS_RQ_IS_FLUSH(rq) && !CAS_RQ_IS_DISCARD(rq)) {
+		if (unlikely(blk_rq_bytes(rq) == 0)) {
+			CAS_PRINT_RL(KERN_ERR
+				"Not able to handle empty request\n");
+			return CAS_BLK_STS_IOERR;
+		}
+
+		segments = blkdev_rq_segments(rq);
+		if (segments > BLKDEV_RQ_INLINE_VECS) {
+			data = cas_alloc_blk_data(segments, GFP_NOIO);
+			if (!data) {
+				CAS_PRINT_RL(KERN_CRIT
+					"BIO data vector allocation error\n");
+				return CAS_BLK_STS_RESOURCE;
+			}
+		} else {
+			data->size = segments;
+		}
+
+		blkdev_set_rq_data(data, rq);
+	}
+
+	io = blkdev_rq_new_io(bvol, queue, rq, data);
+	if (!io) {
+		CAS_PRINT_RL(KERN_CRIT "Out of memory. Requeuing request.\n");
+		if (data != &ctx->data)
+			cas_free_blk_data(data);
+		return CAS_BLK_STS_RESOURCE;
+	}
+
+	if (!CAS_RQ_IS_FLUSH(rq) && !CAS_RQ_IS_DISCARD(rq)) {
+		ret = ocf_io_set_data(io, data, 0);
+		if (ret < 0) {
+			ocf_io_put(io);
+			if (data != &ctx->data)
+				cas_free_blk_data(data);
+			return CAS_ERRNO_TO_BLK_STS(-EINVAL);
+		}
+	}
+
+	ocf_io_set_cmpl(io, rq, data, blkdev_complete_rq);
+
+	blk_mq_start_request(rq);
+
+	if (CAS_RQ_IS_FLUSH(rq))
+		ocf_volume_submit_flush(io);
+	else if (CAS_RQ_IS_DISCARD(rq))
+		ocf_volume_submit_discard(io);
+	else
+		ocf_volume_submit_io(io);
+
+	return CAS_BLK_STS_OK;
+}
+
+static CAS_BLK_STATUS_T blkdev_core_queue_rq(struct casdsk_disk *dsk,
+		struct request *rq, unsigned int hctx_idx, void *private)
+{
+	ocf_core_t core = private;
+	struct bd_object *bvol;
+
+	BUG_ON(!core);
+
+	bvol = bd_object(ocf_core_get_volume(core));
+
+	return blkdev_queue_rq(bvol, rq, hctx_idx);
+}
+
+static struct casdsk_exp_obj_ops kcas_core_exp_obj_mq_ops = {
+	.set_geometry = blkdev_core_set_geometry,
+	.submit_bio = blkdev_core_submit_bio,
+	.queue_rq = blkdev_core_queue_rq,
+	.rq_pdu_size = BLKDEV_RQ_PDU_SIZE,
 };
 
 static int blkdev_cache_set_geometry(struct casdsk_disk *dsk, void *private)
@@ -509,9 +773,20 @@ static void blkdev_cache_submit_bio(struct casdsk_disk *dsk,
 	blkdev_submit_bio(bvol, bio);
 }
 
+static int blkdev_cache_poll_bio(struct casdsk_disk *dsk, struct bio *bio,
+		void *private)
+{
+	ocf_cache_t cache = private;
+
+	BUG_ON(!cache);
+
+	return blkdev_poll_bio(bd_object(ocf_cache_get_volume(cache)), bio);
+}
+
 static struct casdsk_exp_obj_ops kcas_cache_exp_obj_ops = {
 	.set_geometry = blkdev_cache_set_geometry,
 	.submit_bio = blkdev_cache_submit_bio,
+	.poll_bio = blkdev_cache_poll_bio,
 };
 
 /****************************************
@@ -551,10 +826,17 @@ static int kcas_volume_create_exported_object(ocf_volume_t volume,
 		goto end;
 	}
 
+	result = blkdev_defer_queues_init(bvol);
+	if (result) {
+		destroy_workqueue(bvol->expobj_wq);
+		goto end;
+	}
+
 	result = casdisk_functions.casdsk_exp_obj_create(dsk, name,
 			THIS_MODULE, ops);
 	if (result) {
 		destroy_workqueue(bvol->expobj_wq);
+		blkdev_defer_queues_deinit(bvol);
 		goto end;
 	}
 
@@ -593,6 +875,7 @@ static int kcas_volume_destroy_exported_object(ocf_volume_t volume)
 
 	bvol->expobj_valid = false;
 	destroy_workqueue(bvol->expobj_wq);
+	blkdev_defer_queues_deinit(bvol);
 
 out:
 	casdisk_functions.casdsk_exp_obj_unlock(bvol->dsk);
@@ -616,7 +899,14 @@ static int kcas_volume_activate_exported_object(ocf_volume_t volume,
 	return result;
 }
 
-int kcas_core_create_exported_object(ocf_core_t core)
+static inline struct casdsk_exp_obj_ops *kcas_core_exp_obj_ops_get(
+		struct bd_object *bvol)
+{
+	return bvol->expobj_blk_mq ? &kcas_core_exp_obj_mq_ops :
+			&kcas_core_exp_obj_ops;
+}
+
+int kcas_core_create_exported_object(ocf_core_t core, bool blk_mq)
 {
 	ocf_cache_t cache = ocf_core_get_cache(core);
 	ocf_volume_t volume = ocf_core_get_volume(core);
@@ -628,9 +918,10 @@ int kcas_core_create_exported_object(ocf_core_t core)
 			get_core_id_string(core));
 
 	bvol->front_volume = ocf_core_get_front_volume(core);
+	bvol->expobj_blk_mq = blk_mq;
 
 	return kcas_volume_create_exported_object(volume, dev_name, core,
-			&kcas_core_exp_obj_ops);
+			kcas_core_exp_obj_ops_get(bvol));
 }
 
 int kcas_core_destroy_exported_object(ocf_core_t core)
@@ -647,7 +938,7 @@ int kcas_core_activate_exported_object(ocf_core_t core)
 	int result;
 
 	result = kcas_volume_activate_exported_object(volume,
-			&kcas_core_exp_obj_ops);
+			kcas_core_exp_obj_ops_get(bd_object(volume)));
 	if (result) {
 		printk(KERN_ERR "Cannot activate exported object, %s.%s. "
 				"Error code %d\n", ocf_cache_get_name(cache),
@@ -750,6 +1041,7 @@ static int kcas_core_stop_exported_object(ocf_core_t core, void *cntx)
 		if (!ret) {
 			bvol->expobj_valid = false;
 			destroy_workqueue(bvol->expobj_wq);
+			blkdev_defer_queues_deinit(bvol);
 		}
 	}
 
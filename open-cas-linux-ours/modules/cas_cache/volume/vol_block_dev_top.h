@@ -7,7 +7,7 @@
 #define __VOL_BLOCK_DEV_TOP_H__
 
 
-int kcas_core_create_exported_object(ocf_core_t core);
+int kcas_core_create_exported_object(ocf_core_t core, bool blk_mq);
 int kcas_core_destroy_exported_object(ocf_core_t core);
 int kcas_core_activate_exported_object(ocf_core_t core);
 
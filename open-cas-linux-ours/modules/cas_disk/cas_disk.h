@@ -11,7 +11,7 @@
 /**
  * Version of cas_disk interface
  */
-#define CASDSK_IFACE_VERSION 3
+#define CASDSK_IFACE_VERSION 5
 
 struct casdsk_disk;
 
@@ -29,6 +29,34 @@ struct casdsk_exp_obj_ops {
 	 */
 	void (*submit_bio)(struct casdsk_disk *dsk,
 			       struct bio *bio, void *private);
+
+	/**
+	 * @brief poll_bio of exported object (top) block device.
+	 *	Could be NULL. If set, bio based exported object advertises
+	 *	polling support. Called by cas_disk when cas_disk device is in
+	 *	attached mode. Returns number of completions found.
+	 */
+	int (*poll_bio)(struct casdsk_disk *dsk, struct bio *bio,
+			void *private);
+
+	/**
+	 * @brief queue_rq of exported object (top) block device.
+	 *	Could be NULL. If set, exported object is created as native
+	 *	blk-mq device and requests are delivered here instead of
+	 *	submit_bio. Called by cas_disk when cas_disk device is in
+	 *	attached mode, hctx_idx is index of hardware context request
+	 *	was dispatched from. Such exported object can't be switched to
+	 *	pass-through mode.
+	 */
+	CAS_BLK_STATUS_T (*queue_rq)(struct casdsk_disk *dsk,
+			struct request *rq, unsigned int hctx_idx,
+			void *private);
+
+	/**
+	 * @brief Size of per-request private data allocated along with each
+	 *	blk-mq tag. Used only if queue_rq is set.
+	 */
+	unsigned int rq_pdu_size;
 };
 
 /**
@@ -85,7 +113,8 @@ struct gendisk *casdsk_disk_get_gendisk(struct casdsk_disk *dsk);
 /**
  * @brief Prepare cas_disk device to switch to pass-through mode
  * @param dsk Pointer to casdsk_disk structure related to cas_disk device
- * @return 0 if success, errno if failure
+ * @return 0 if success, errno if failure (-EOPNOTSUPP if exported object
+ *	is native blk-mq device, which does not support pass-through)
  */
 int casdsk_disk_set_pt(struct casdsk_disk *dsk);
 
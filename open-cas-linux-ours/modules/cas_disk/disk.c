@@ -318,6 +318,11 @@ int casdsk_disk_set_pt(struct casdsk_disk *dsk)
 	if (!dsk->exp_obj)
 		return 0;
 
+	/* Requests of native blk-mq object can't be forwarded to bottom
+	 * device as bios, so it has to stay attached */
+	if (casdsk_exp_obj_is_mq(dsk))
+		return -EOPNOTSUPP;
+
 	casdsk_disk_lock(dsk);
 	result = __casdsk_disk_set_pt(dsk);
 	casdsk_disk_unlock(dsk);
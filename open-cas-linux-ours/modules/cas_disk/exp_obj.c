@@ -183,6 +183,30 @@ static MAKE_RQ_RET_TYPE _casdsk_exp_obj_submit_bio(struct bio *bio)
 	KRETURN(0);
 }
 
+#ifdef CAS_POLL_BIO_SUPPORTED
+static int _casdsk_exp_obj_poll_bio(struct bio *bio,
+		struct io_comp_batch *iob, unsigned int flags)
+{
+	struct casdsk_disk *dsk;
+	unsigned int cpu;
+	int result = 0;
+
+	BUG_ON(!bio);
+	dsk = CAS_BIO_GET_GENDISK(bio)->private_data;
+
+	cpu = _casdsk_exp_obj_begin_rq(dsk);
+
+	if (likely(casdsk_disk_is_attached(dsk)) &&
+			dsk->exp_obj->ops->poll_bio) {
+		result = dsk->exp_obj->ops->poll_bio(dsk, bio, dsk->private);
+	}
+
+	_casdsk_exp_obj_end_rq(dsk, cpu);
+
+	return result;
+}
+#endif
+
 static MAKE_RQ_RET_TYPE _casdsk_exp_obj_make_rq_fn(struct request_queue *q,
 						 struct bio *bio)
 {
@@ -378,6 +402,16 @@ static const struct block_device_operations _casdsk_exp_obj_ops = {
 	.open = _casdsk_exp_obj_open,
 	.release = _casdsk_exp_obj_close,
 	CAS_SET_SUBMIT_BIO(_casdsk_exp_obj_submit_bio)
+#ifdef CAS_POLL_BIO_SUPPORTED
+	CAS_SET_POLL_BIO(_casdsk_exp_obj_poll_bio)
+#endif
+};
+
+/* Native blk-mq exported object - requests are delivered via queue_rq */
+static const struct block_device_operations _casdsk_exp_obj_mq_ops = {
+	.owner = THIS_MODULE,
+	.open = _casdsk_exp_obj_open,
+	.release = _casdsk_exp_obj_close,
 };
 
 static int casdsk_exp_obj_alloc(struct casdsk_disk *dsk)
@@ -477,7 +511,27 @@ static int _casdsk_exp_obj_init_kobject(struct casdsk_disk *dsk)
 static CAS_BLK_STATUS_T _casdsk_exp_obj_queue_rq(struct blk_mq_hw_ctx *hctx,
 		const struct blk_mq_queue_data *bd)
 {
-	return CAS_BLK_STS_NOTSUPP;
+	struct casdsk_disk *dsk = hctx->driver_data;
+	struct request *rq = bd->rq;
+	CAS_BLK_STATUS_T result;
+	unsigned int cpu;
+
+	cpu = _casdsk_exp_obj_begin_rq(dsk);
+
+	/* Native blk-mq object never enters pass-through, see
+	 * casdsk_disk_set_pt() */
+	if (likely(casdsk_disk_is_attached(dsk))) {
+		result = dsk->exp_obj->ops->queue_rq(dsk, rq, hctx->queue_num,
+				dsk->private);
+	} else if (casdsk_disk_is_shutdown(dsk)) {
+		result = CAS_BLK_STS_IOERR;
+	} else {
+		BUG();
+	}
+
+	_casdsk_exp_obj_end_rq(dsk, cpu);
+
+	return result;
 }
 
 static struct blk_mq_ops casdsk_mq_ops = {
@@ -501,18 +555,27 @@ static void _casdsk_init_queues(struct casdsk_disk *dsk)
 	}
 }
 
+static inline bool _casdsk_exp_obj_is_mq(struct casdsk_exp_obj_ops *ops)
+{
+	return !!ops->queue_rq;
+}
+
 static int _casdsk_init_tag_set(struct casdsk_disk *dsk, struct blk_mq_tag_set *set)
 {
+	struct casdsk_exp_obj_ops *ops;
+
 	BUG_ON(!dsk);
 	BUG_ON(!set);
 
+	ops = dsk->exp_obj->ops;
+
 	set->ops = &casdsk_mq_ops;
 	set->nr_hw_queues = num_online_cpus();
 	set->numa_node = NUMA_NO_NODE;
 	/*TODO: Should we inherit qd from core device? */
 	set->queue_depth = BLKDEV_MAX_RQ;
 
-	set->cmd_size = 0;
+	set->cmd_size = _casdsk_exp_obj_is_mq(ops) ? ops->rq_pdu_size : 0;
 	set->flags = BLK_MQ_F_SHOULD_MERGE | CAS_BLK_MQ_F_STACKING | CAS_BLK_MQ_F_BLOCKING;
 
 	set->driver_data = dsk;
@@ -585,11 +648,17 @@ int casdsk_exp_obj_create(struct casdsk_disk *dsk, const char *dev_name,
 
 	_casdsk_init_queues(dsk);
 
-	gd->fops = &_casdsk_exp_obj_ops;
 	gd->private_data = dsk;
 	strlcpy(gd->disk_name, exp_obj->dev_name, sizeof(gd->disk_name));
 
-	cas_blk_queue_make_request(queue, _casdsk_exp_obj_make_rq_fn);
+	if (_casdsk_exp_obj_is_mq(ops)) {
+		gd->fops = &_casdsk_exp_obj_mq_ops;
+	} else {
+		gd->fops = &_casdsk_exp_obj_ops;
+		cas_blk_queue_make_request(queue, _casdsk_exp_obj_make_rq_fn);
+		if (ops->poll_bio)
+			CAS_SET_QUEUE_POLL(queue);
+	}
 
 	if (exp_obj->ops->set_geometry) {
 		result = exp_obj->ops->set_geometry(dsk, dsk->private);
@@ -796,9 +865,20 @@ int casdsk_exp_obj_detach(struct casdsk_disk *dsk)
 	return 0;
 }
 
+bool casdsk_exp_obj_is_mq(struct casdsk_disk *dsk)
+{
+	return dsk->exp_obj->gd->fops == &_casdsk_exp_obj_mq_ops;
+}
+
 int casdsk_exp_obj_attach(struct casdsk_disk *dsk, struct module *owner,
 			struct casdsk_exp_obj_ops *ops)
 {
+	/* Request delivery model is fixed when queue is created */
+	if (_casdsk_exp_obj_is_mq(ops) != casdsk_exp_obj_is_mq(dsk)) {
+		CASDSK_DEBUG_DISK_ERROR(dsk, "Exported object type mismatch");
+		return -EINVAL;
+	}
+
 	if (!try_module_get(owner)) {
 		CASDSK_DEBUG_DISK_ERROR(dsk, "Cannot get reference to module");
 		return -ENAVAIL;
@@ -23,6 +23,22 @@ EXTRA_CFLAGS += -I$(M)/cas_cache
 EXTRA_CFLAGS += -I$(M)/include
 EXTRA_CFLAGS += -DCAS_KERNEL=\"$(KERNELRELEASE)\"
 
+# Pack core id and core line of each cache line into a single 64-bit word
+ifeq ($(CAS_COMPACT_METADATA),1)
+EXTRA_CFLAGS += -DOCF_CONFIG_COMPACT_METADATA=1
+endif
+
+# Per lock class acquisition, contention and wait/hold time statistics,
+# dumped to /sys/kernel/debug/cas_cache/lock_stats
+ifeq ($(CAS_LOCK_STATS),1)
+EXTRA_CFLAGS += -DCAS_LOCK_STATS
+endif
+
+# Verify data copy engine and print its timings on module load
+ifeq ($(CAS_DATA_CPY_SELFTEST),1)
+EXTRA_CFLAGS += -DCAS_DATA_CPY_SELFTEST
+endif
+
 check_header=$(shell echo "\#include <${1}>" | \
 	gcc -c -xc -o /dev/null - 2>/dev/null; \
 	if [ $$? -eq 0 ]; then echo 1; else echo 0; fi; )
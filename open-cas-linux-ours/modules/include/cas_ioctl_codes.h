@@ -76,6 +76,11 @@ struct kcas_start_cache {
 
 	uint64_t min_free_ram; /**< Minimum free RAM memory for cache metadata */
 
+	/**
+	 * cap on RAM used by cache metadata in bytes, 0 - no limit
+	 */
+	uint64_t memory_budget;
+
 	char cache_elevator[MAX_ELEVATOR_NAME];
 
 	int ext_err_code;
@@ -107,6 +112,8 @@ struct kcas_insert_core {
 	bool update_path; /**< provide alternative path for core device */
 
 	int ext_err_code;
+
+	bool blk_mq; /**< expose core through native blk-mq request path */
 };
 
 struct kcas_remove_core {
@@ -370,6 +377,26 @@ struct kcas_standby_activate
 	int ext_err_code;
 };
 
+struct kcas_cache_memory {
+	/** id of a cache */
+	uint16_t cache_id;
+
+	/** RAM used by cache metadata and policies */
+	struct ocf_cache_memory_footprint footprint;
+
+	int ext_err_code;
+};
+
+struct kcas_cache_lock_stats {
+	/** id of a cache */
+	uint16_t cache_id;
+
+	/** cache line lock contention statistics */
+	struct ocf_cache_lock_stats stats;
+
+	int ext_err_code;
+};
+
 /*******************************************************************************
  *   CODE   *              NAME             *               STATUS             *
  *******************************************************************************
@@ -411,6 +438,8 @@ struct kcas_standby_activate
  *    38    *    KCAS_IOCTL_STANDBY_DETACH                  *    OK            *
  *    39    *    KCAS_IOCTL_STANDBY_ACTIVATE                *    OK            *
  *    40    *    KCAS_IOCTL_CORE_INFO                       *    OK            *
+ *    41    *    KCAS_IOCTL_CACHE_MEMORY                    *    OK            *
+ *    42    *    KCAS_IOCTL_CACHE_LOCK_STATS                *    OK            *
  *******************************************************************************
  */
 
@@ -509,6 +538,12 @@ struct kcas_standby_activate
 /** Rretrieve statisting of a given core object */
 #define KCAS_IOCTL_CORE_INFO _IOWR(KCAS_IOCTL_MAGIC, 40, struct kcas_core_info)
 
+/** Retrieve RAM footprint of cache metadata and policies */
+#define KCAS_IOCTL_CACHE_MEMORY _IOWR(KCAS_IOCTL_MAGIC, 41, struct kcas_cache_memory)
+
+/** Retrieve cache line lock contention statistics */
+#define KCAS_IOCTL_CACHE_LOCK_STATS _IOWR(KCAS_IOCTL_MAGIC, 42, struct kcas_cache_lock_stats)
+
 /**
  * Extended kernel CAS error codes
  */
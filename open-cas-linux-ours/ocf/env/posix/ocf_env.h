@@ -491,6 +491,31 @@ static inline long env_atomic64_cmpxchg(env_atomic64 *a, long old_v, long new_v)
 	return __sync_val_compare_and_swap(&a->counter, old_v, new_v);
 }
 
+static inline void env_smp_rmb(void)
+{
+	__sync_synchronize();
+}
+
+static inline void env_smp_wmb(void)
+{
+	__sync_synchronize();
+}
+
+static inline void env_smp_mb(void)
+{
+	__sync_synchronize();
+}
+
+static inline void env_prefetch(const void *addr)
+{
+	__builtin_prefetch(addr, 0);
+}
+
+static inline void env_prefetchw(const void *addr)
+{
+	__builtin_prefetch(addr, 1);
+}
+
 /* SPIN LOCKS */
 typedef struct {
 	pthread_spinlock_t lock;
@@ -20,6 +20,9 @@ enum {
 	env_mpool_32,
 	env_mpool_64,
 	env_mpool_128,
+	env_mpool_256,
+	env_mpool_512,
+	env_mpool_1024,
 
 	env_mpool_max
 };
@@ -98,6 +98,70 @@ struct ocf_cache_info {
 		/*!< true if cache volume detached in standby mode */
 };
 
+/**
+ * @brief Cache DRAM footprint broken down per metadata segment and policy
+ *
+ * All values are in bytes.
+ */
+struct ocf_cache_memory_footprint {
+	uint64_t superblock;
+		/*!< Superblock config, runtime and reserved segments */
+
+	uint64_t partitions;
+		/*!< Partition config and runtime segments */
+
+	uint64_t cores;
+		/*!< Core config, runtime and UUID segments */
+
+	uint64_t cleaning;
+		/*!< Per cache line cleaning policy segment */
+
+	uint64_t lru;
+		/*!< Per cache line LRU segment and runtime LRU state (second
+		 * chance reference bitmap, occupancy shards) */
+
+	uint64_t collision;
+		/*!< Collision table segment */
+
+	uint64_t list_info;
+		/*!< Per cache line partition list segment */
+
+	uint64_t hash;
+		/*!< Hash table segment */
+
+	uint64_t cache_line_locks;
+		/*!< Cache line concurrency (alock access array) */
+
+	uint64_t metadata_locks;
+		/*!< Hash bucket and collision page locks */
+
+	uint64_t cleaning_policy;
+		/*!< Runtime cleaning policy context (e.g. ACP chunks) */
+
+	uint64_t promotion_policy;
+		/*!< Runtime promotion policy context (e.g. nhit hash) */
+
+	uint64_t total;
+		/*!< Sum of all above */
+
+	uint64_t budget;
+		/*!< Memory budget cache was started with, 0 if unlimited */
+};
+
+/**
+ * @brief Cache line lock contention statistics
+ */
+struct ocf_cache_lock_stats {
+	uint64_t waits;
+		/*!< Number of times request had to wait for cache line lock */
+
+	uint64_t wait_time_ns;
+		/*!< Total time spent waiting for cache line locks */
+
+	uint64_t waiter_allocs;
+		/*!< Waiters allocated because queue waiter pool was empty */
+};
+
 /**
  * @brief Obtain volume from cache
  *
@@ -223,6 +287,30 @@ uint32_t ocf_cache_get_core_count(ocf_cache_t cache);
  */
 int ocf_cache_get_info(ocf_cache_t cache, struct ocf_cache_info *info);
 
+/**
+ * @brief Get DRAM footprint of cache metadata and policies
+ *
+ * @param[in] cache Cache object
+ * @param[out] footprint Memory footprint breakdown
+ *
+ * @retval 0 Success
+ * @retval Non-zero Fail
+ */
+int ocf_cache_get_memory_footprint(ocf_cache_t cache,
+		struct ocf_cache_memory_footprint *footprint);
+
+/**
+ * @brief Get cache line lock contention statistics
+ *
+ * @param[in] cache Cache object
+ * @param[out] stats Lock contention statistics
+ *
+ * @retval 0 Success
+ * @retval Non-zero Fail
+ */
+int ocf_cache_get_lock_stats(ocf_cache_t cache,
+		struct ocf_cache_lock_stats *stats);
+
 /**
  * @brief Get UUID of volume associated with cache
  *
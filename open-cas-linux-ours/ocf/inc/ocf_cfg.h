@@ -28,6 +28,41 @@
 #error "Limit of maximum number of IO classes exceeded"
 #endif
 
+/**
+ * Use compact collision metadata format. Core id and core line are packed
+ * into a single 64-bit word, which limits core size to 2^48 cache lines.
+ * Metadata written with compact format is incompatible with regular one.
+ */
+#ifndef OCF_CONFIG_COMPACT_METADATA
+#define OCF_CONFIG_COMPACT_METADATA 0
+#endif
+
+#if OCF_CONFIG_COMPACT_METADATA && OCF_CONFIG_MAX_CORES >= (1 << 16)
+#error "Compact metadata format supports up to 65535 cores"
+#endif
+
+/**
+ * Look up read hits without taking hash bucket locks. Collision chains are
+ * traversed under per hash bucket sequence counters and the lookup falls back
+ * to the locked path on any concurrent modification.
+ */
+#ifndef OCF_CONFIG_OPTIMISTIC_LOOKUP
+#define OCF_CONFIG_OPTIMISTIC_LOOKUP 1
+#endif
+
+/**
+ * Minimal number of cache lines in request for which cache line locks are
+ * acquired per physically contiguous run of cache lines rather than line
+ * by line. 0 disables range locking.
+ *
+ * Runs are still locked with one trylock per cache line, so this only pays
+ * off where whole run rollback beats line by line waiting. Disabled by
+ * default until it is shown to do so.
+ */
+#ifndef OCF_CONFIG_RANGE_LOCK_MIN_LINES
+#define OCF_CONFIG_RANGE_LOCK_MIN_LINES 0
+#endif
+
 /** Enabling debug statistics */
 #ifndef OCF_CONFIG_DEBUG_STATS
 #define OCF_CONFIG_DEBUG_STATS 0
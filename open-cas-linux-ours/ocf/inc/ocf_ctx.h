@@ -125,6 +125,18 @@ struct ocf_data_ops {
 	 * @param[in] dst Contex data buffer which shall be erased
 	 */
 	void (*secure_erase)(ctx_data_t *dst);
+
+	/**
+	 * @brief Allocate zeroed context data buffer (optional)
+	 *
+	 * Buffers returned by alloc() are not initialized. When zalloc is
+	 * not provided OCF zeroes buffer allocated by alloc() itself.
+	 *
+	 * @param[in] pages The size of data buffer in pages
+	 *
+	 * @return Context data buffer
+	 */
+	ctx_data_t *(*zalloc)(uint32_t pages);
 };
 
 /**
@@ -178,6 +178,25 @@ typedef enum {
 		/*!< Current cache mode of given cache instance */
 } ocf_cache_mode_t;
 
+/**
+ * Read miss backfill modes
+ */
+typedef enum {
+	ocf_backfill_mode_copy = 0,
+		/*!< Copy core data to private buffer, complete user request
+		 * and backfill cache from the copy */
+
+	ocf_backfill_mode_user_pages,
+		/*!< Backfill cache directly from user pages, complete user
+		 * request once backfill is finished */
+
+	ocf_backfill_mode_max,
+		/*!< Stopper of backfill mode enumerator */
+
+	ocf_backfill_mode_default = ocf_backfill_mode_copy,
+		/*!< Default backfill mode */
+} ocf_backfill_mode_t;
+
 #define OCF_SEQ_CUTOFF_PERCORE_STREAMS 128
 #define OCF_SEQ_CUTOFF_PERQUEUE_STREAMS 64
 #define OCF_SEQ_CUTOFF_MIN_THRESHOLD 1
@@ -280,13 +280,31 @@ struct ocf_mngt_cache_config {
 	 */
 	bool use_submit_io_fast;
 
+	/**
+	 * @brief If set, requests which were granted cache line lock
+	 *	asynchronously are resumed directly in the unlocking context
+	 *	when it is safe, instead of being requeued.
+	 */
+	bool inline_resume;
+
 	/**
 	 * @brief Backfill configuration
 	 */
 	struct {
 		 uint32_t max_queue_size;
 		 uint32_t queue_unblock_size;
+		 ocf_backfill_mode_t mode;
+			/*!< Trade-off between read miss latency (copy) and
+			 * CPU/memory cost of backfill (user_pages) */
 	} backfill;
+
+	/**
+	 * @brief Cap (in bytes) on DRAM used by cache metadata and policies,
+	 *	0 means no limit. When set, compact policy encodings (e.g.
+	 *	smaller nhit hash) are picked on attach to fit the budget and
+	 *	attach fails if metadata does not fit even then.
+	 */
+	uint64_t memory_budget;
 };
 
 /**
@@ -306,9 +324,12 @@ static inline void ocf_mngt_cache_config_set_default(
 	cfg->metadata_volatile = false;
 	cfg->backfill.max_queue_size = 65536;
 	cfg->backfill.queue_unblock_size = 60000;
+	cfg->backfill.mode = ocf_backfill_mode_default;
 	cfg->locked = false;
 	cfg->pt_unaligned_io = false;
 	cfg->use_submit_io_fast = false;
+	cfg->inline_resume = false;
+	cfg->memory_budget = 0;
 }
 
 /**
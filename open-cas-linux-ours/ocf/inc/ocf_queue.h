@@ -11,6 +11,51 @@
  * @brief OCF queues API
  */
 
+/**
+ * @brief I/O queue priority lanes
+ */
+typedef enum {
+	ocf_queue_lane_user_read = 0,
+		/*!< User read requests */
+
+	ocf_queue_lane_user_write,
+		/*!< User write requests */
+
+	ocf_queue_lane_background,
+		/*!< Cleaner, flush and metadata update requests */
+
+	ocf_queue_lane_mngt,
+		/*!< Management requests */
+
+	ocf_queue_lane_max,
+		/*!< Stopper of queue lane enumerator */
+} ocf_queue_lane_t;
+
+/**
+ * @brief Lane weight which makes lane served whenever it has pending requests
+ */
+#define OCF_QUEUE_LANE_WEIGHT_STRICT 0
+
+/**
+ * @brief I/O queue request allocation statistics
+ */
+struct ocf_queue_req_alloc_stats {
+	uint64_t map_inline;
+		/*!< Maps allocated inline with request from request mpool */
+
+	uint64_t map_pool;
+		/*!< Maps allocated from dedicated map mpool */
+
+	uint64_t map_fallback;
+		/*!< Maps allocated from general purpose allocator */
+
+	uint64_t req_allocated;
+		/*!< Requests allocated from request mpool */
+
+	uint64_t req_recycled;
+		/*!< Requests reused from queue free lists */
+};
+
 /**
  * @brief I/O queue operations
  */
@@ -117,6 +162,32 @@ void *ocf_queue_get_priv(ocf_queue_t q);
  */
 uint32_t ocf_queue_pending_io(ocf_queue_t q);
 
+/**
+ * @brief Set weight of I/O queue priority lane
+ *
+ * Lanes are drained in weighted round robin manner - in each round lane
+ * may dispatch up to weight requests before lanes with lower priority.
+ * Lane with weight OCF_QUEUE_LANE_WEIGHT_STRICT is never throttled.
+ *
+ * @param[in] q I/O queue
+ * @param[in] lane Priority lane
+ * @param[in] weight Lane weight
+ *
+ * @retval 0 Success
+ * @retval Non-zero Invalid lane
+ */
+int ocf_queue_set_lane_weight(ocf_queue_t q, ocf_queue_lane_t lane,
+		uint32_t weight);
+
+/**
+ * @brief Get I/O queue request allocation statistics
+ *
+ * @param[in] q I/O queue
+ * @param[out] stats Request allocation statistics
+ */
+void ocf_queue_get_req_alloc_stats(ocf_queue_t q,
+		struct ocf_queue_req_alloc_stats *stats);
+
 /**
  * @brief Get cache instance to which I/O queue belongs
  *
@@ -236,6 +236,14 @@ void cleaning_policy_acp_deinitialize(struct ocf_cache *cache)
 	cache->cleaner.cleaning_policy_context = NULL;
 }
 
+size_t cleaning_policy_acp_size_of(struct ocf_cache *cache)
+{
+	struct acp_context *acp = _acp_get_ctx_from_cache(cache);
+
+	return sizeof(*acp) +
+		acp->chunks_total * sizeof(acp->chunk_info[0][0]);
+}
+
 static void _acp_rebuild(struct ocf_cache *cache)
 {
 	ocf_cache_line_t cline;
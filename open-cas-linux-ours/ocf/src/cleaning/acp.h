@@ -17,6 +17,8 @@ void cleaning_policy_acp_recovery(ocf_cache_t cache,
 
 void cleaning_policy_acp_deinitialize(ocf_cache_t cache);
 
+size_t cleaning_policy_acp_size_of(ocf_cache_t cache);
+
 void cleaning_policy_acp_perform_cleaning(ocf_cache_t cache,
 		ocf_cleaner_end_t cmpl);
 
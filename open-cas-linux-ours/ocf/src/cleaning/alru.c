@@ -636,6 +636,11 @@ void cleaning_policy_alru_deinitialize(struct ocf_cache *cache)
 	cache->cleaner.cleaning_policy_context = NULL;
 }
 
+size_t cleaning_policy_alru_size_of(struct ocf_cache *cache)
+{
+	return sizeof(struct alru_context);
+}
+
 int cleaning_policy_alru_set_cleaning_param(ocf_cache_t cache,
 		uint32_t param_id, uint32_t param_value)
 {
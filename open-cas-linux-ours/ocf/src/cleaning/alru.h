@@ -14,6 +14,7 @@ int cleaning_policy_alru_initialize(ocf_cache_t cache, int init_metadata);
 void cleaning_policy_alru_recovery(ocf_cache_t cache,
                 ocf_cleaning_recovery_end_t cmpl, void *priv);
 void cleaning_policy_alru_deinitialize(ocf_cache_t cache);
+size_t cleaning_policy_alru_size_of(ocf_cache_t cache);
 void cleaning_policy_alru_init_cache_block(ocf_cache_t cache,
 		uint32_t cache_line);
 void cleaning_policy_alru_purge_cache_block(ocf_cache_t cache,
@@ -29,6 +29,7 @@ struct cleaning_policy_ops {
 	int (*get_cleaning_param)(ocf_cache_t cache, uint32_t param_id,
 			uint32_t *param_value);
 	void (*perform_cleaning)(ocf_cache_t cache, ocf_cleaner_end_t cmpl);
+	size_t (*size_of)(ocf_cache_t cache);
 	const char *name;
 };
 
@@ -50,6 +51,7 @@ static struct cleaning_policy_ops cleaning_policy_ops[ocf_cleaning_max] = {
 		.set_cleaning_param = cleaning_policy_alru_set_cleaning_param,
 		.get_cleaning_param = cleaning_policy_alru_get_cleaning_param,
 		.perform_cleaning = cleaning_alru_perform_cleaning,
+		.size_of = cleaning_policy_alru_size_of,
 		.name = "alru",
 	},
 	[ocf_cleaning_acp] = {
@@ -66,6 +68,7 @@ static struct cleaning_policy_ops cleaning_policy_ops[ocf_cleaning_max] = {
 		.add_core = cleaning_policy_acp_add_core,
 		.remove_core = cleaning_policy_acp_remove_core,
 		.perform_cleaning = cleaning_policy_acp_perform_cleaning,
+		.size_of = cleaning_policy_acp_size_of,
 		.name = "acp",
 	},
 };
@@ -119,6 +122,23 @@ static inline void ocf_cleaning_deinitialize(ocf_cache_t cache)
 	cleaning_policy_ops[policy].deinitialize(cache);
 }
 
+static inline size_t ocf_cleaning_size_of(ocf_cache_t cache)
+{
+	ocf_cleaning_t policy;
+
+	policy = cache->cleaner.policy;
+
+	ENV_BUG_ON(policy >= ocf_cleaning_max);
+
+	if (unlikely(!cleaning_policy_ops[policy].size_of))
+		return 0;
+
+	if (!cache->cleaner.cleaning_policy_context)
+		return 0;
+
+	return cleaning_policy_ops[policy].size_of(cache);
+}
+
 static inline int ocf_cleaning_add_core(ocf_cache_t cache,
 		ocf_core_id_t core_id)
 {
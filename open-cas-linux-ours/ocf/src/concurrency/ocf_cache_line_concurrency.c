@@ -33,12 +33,93 @@ static ocf_cache_line_t ocf_cl_lock_line_get_entry(
 	return req->map[index].coll_idx;
 }
 
+/* Returns number of entries starting at index which need lock and are
+ * mapped to physically contiguous cache lines.
+ */
+static uint32_t ocf_cl_lock_line_run(struct ocf_alock *alock,
+		struct ocf_request *req, unsigned index)
+{
+	ocf_cache_line_t entry = ocf_cl_lock_line_get_entry(alock, req, index);
+	uint32_t run = 1;
+
+	while (index + run < req->core_line_count &&
+			ocf_cl_lock_line_needs_lock(alock, req, index + run) &&
+			ocf_cl_lock_line_get_entry(alock, req, index + run) ==
+					entry + run) {
+		run++;
+	}
+
+	return run;
+}
+
+/* Range lock mode - each physically contiguous run of cache lines is
+ * locked as a whole. Fragmented mapping degenerates into runs of single
+ * cache line, which is equivalent to per line locking.
+ */
+static int ocf_cl_lock_range_fast(struct ocf_alock *alock,
+		struct ocf_request *req, int rw)
+{
+	uint32_t i, j, run;
+	ocf_cache_line_t entry;
+	struct list_head granted;
+
+	INIT_LIST_HEAD(&granted);
+
+	for (i = 0; i < req->core_line_count; i += run) {
+		if (!ocf_cl_lock_line_needs_lock(alock, req, i)) {
+			run = 1;
+			continue;
+		}
+
+		entry = ocf_cl_lock_line_get_entry(alock, req, i);
+		run = ocf_cl_lock_line_run(alock, req, i);
+
+		if (!ocf_alock_trylock_range(alock, entry, run, rw, &granted))
+			goto unlock;
+
+		for (j = i; j < i + run; j++)
+			ocf_alock_mark_index_locked(alock, req, j, true);
+	}
+
+	return OCF_LOCK_ACQUIRED;
+
+unlock:
+	/* Not possible to lock all cachelines, discard acquired locks */
+	for (j = 0; j < i; j++) {
+		if (!ocf_cl_lock_line_needs_lock(alock, req, j))
+			continue;
+
+		if (!ocf_alock_is_index_locked(alock, req, j))
+			continue;
+
+		entry = ocf_cl_lock_line_get_entry(alock, req, j);
+
+		if (rw == OCF_WRITE)
+			ocf_alock_unlock_one_wr_deferred(alock, entry, &granted);
+		else
+			ocf_alock_unlock_one_rd_deferred(alock, entry, &granted);
+		ocf_alock_mark_index_locked(alock, req, j, false);
+	}
+
+	/* Caller may hold hash bucket locks, so waiters granted by rollback
+	 * are only requeued, never resumed inline */
+	ocf_alock_waiters_resume(alock, &granted, false);
+
+	return OCF_LOCK_NOT_ACQUIRED;
+}
+
 static int ocf_cl_lock_line_fast(struct ocf_alock *alock,
 		struct ocf_request *req, int rw)
 {
 	int32_t i;
 	ocf_cache_line_t entry;
 	int ret = OCF_LOCK_ACQUIRED;
+	struct list_head granted;
+
+	if (OCF_CONFIG_RANGE_LOCK_MIN_LINES &&
+			req->core_line_count >= OCF_CONFIG_RANGE_LOCK_MIN_LINES) {
+		return ocf_cl_lock_range_fast(alock, req, rw);
+	}
 
 	for (i = 0; i < req->core_line_count; i++) {
 		if (!ocf_cl_lock_line_needs_lock(alock, req, i)) {
@@ -59,7 +140,7 @@ static int ocf_cl_lock_line_fast(struct ocf_alock *alock,
 				break;
 			}
 		} else {
-			if (ocf_alock_trylock_entry_rd_idle(alock, entry)) {
+			if (ocf_alock_trylock_entry_rd_fast(alock, entry)) {
 				/* cache entry locked */
 				ocf_alock_mark_index_locked(alock, req, i, true);
 			} else {
@@ -73,6 +154,7 @@ static int ocf_cl_lock_line_fast(struct ocf_alock *alock,
 	/* Check if request is locked */
 	if (ret == OCF_LOCK_NOT_ACQUIRED) {
 		/* Request is not locked, discard acquired locks */
+		INIT_LIST_HEAD(&granted);
 		for (; i >= 0; i--) {
 			if (!ocf_cl_lock_line_needs_lock(alock, req, i))
 				continue;
@@ -82,13 +164,17 @@ static int ocf_cl_lock_line_fast(struct ocf_alock *alock,
 			if (ocf_alock_is_index_locked(alock, req, i)) {
 
 				if (rw == OCF_WRITE) {
-					ocf_alock_unlock_one_wr(alock, entry);
+					ocf_alock_unlock_one_wr_deferred(alock,
+							entry, &granted);
 				} else {
-					ocf_alock_unlock_one_rd(alock, entry);
+					ocf_alock_unlock_one_rd_deferred(alock,
+							entry, &granted);
 				}
 				ocf_alock_mark_index_locked(alock, req, i, false);
 			}
 		}
+
+		ocf_alock_waiters_resume(alock, &granted, false);
 	}
 
 	return ret;
@@ -184,13 +270,19 @@ int ocf_req_async_lock_rd(struct ocf_alock *alock,
 	return ocf_alock_lock_rd(alock, req, cmpl);
 }
 
+int ocf_req_trylock_rd(struct ocf_alock *alock, struct ocf_request *req)
+{
+	return ocf_alock_trylock_rd(alock, req);
+}
+
 int ocf_req_async_lock_wr(struct ocf_alock *alock,
 		struct ocf_request *req, ocf_req_async_lock_cb cmpl)
 {
 	return ocf_alock_lock_wr(alock, req, cmpl);
 }
 
-void ocf_req_unlock_rd(struct ocf_alock *alock, struct ocf_request *req)
+static void _ocf_req_unlock(struct ocf_alock *alock, struct ocf_request *req,
+		int rw, struct list_head *granted)
 {
 	int32_t i;
 	ocf_cache_line_t entry;
@@ -204,28 +296,30 @@ void ocf_req_unlock_rd(struct ocf_alock *alock, struct ocf_request *req)
 
 		entry = ocf_cl_lock_line_get_entry(alock, req, i);
 
-		ocf_alock_unlock_one_rd(alock, entry);
+		if (rw == OCF_WRITE)
+			ocf_alock_unlock_one_wr_deferred(alock, entry, granted);
+		else
+			ocf_alock_unlock_one_rd_deferred(alock, entry, granted);
 		ocf_alock_mark_index_locked(alock, req, i, false);
 	}
 }
 
-void ocf_req_unlock_wr(struct ocf_alock *alock, struct ocf_request *req)
+void ocf_req_unlock_rd(struct ocf_alock *alock, struct ocf_request *req)
 {
-	int32_t i;
-	ocf_cache_line_t entry;
-
-	for (i = 0; i < req->core_line_count; i++) {
-		if (!ocf_cl_lock_line_is_acting(alock, req, i))
-			continue;
+	struct list_head granted;
 
-		if (!ocf_alock_is_index_locked(alock, req, i))
-			continue;
+	INIT_LIST_HEAD(&granted);
+	_ocf_req_unlock(alock, req, OCF_READ, &granted);
+	ocf_alock_waiters_resume(alock, &granted, false);
+}
 
-		entry = ocf_cl_lock_line_get_entry(alock, req, i);
+void ocf_req_unlock_wr(struct ocf_alock *alock, struct ocf_request *req)
+{
+	struct list_head granted;
 
-		ocf_alock_unlock_one_wr(alock, entry);
-		ocf_alock_mark_index_locked(alock, req, i, false);
-	}
+	INIT_LIST_HEAD(&granted);
+	_ocf_req_unlock(alock, req, OCF_WRITE, &granted);
+	ocf_alock_waiters_resume(alock, &granted, false);
 }
 
 void ocf_req_unlock(struct ocf_alock *alock, struct ocf_request *req)
@@ -236,6 +330,15 @@ void ocf_req_unlock(struct ocf_alock *alock, struct ocf_request *req)
 		ocf_req_unlock_rd(alock, req);
 }
 
+void ocf_req_unlock_completed(struct ocf_alock *alock, struct ocf_request *req)
+{
+	struct list_head granted;
+
+	INIT_LIST_HEAD(&granted);
+	_ocf_req_unlock(alock, req, req->alock_rw, &granted);
+	ocf_alock_waiters_resume(alock, &granted, true);
+}
+
 bool ocf_cache_line_are_waiters(struct ocf_alock *alock,
 		ocf_cache_line_t line)
 {
@@ -84,6 +84,18 @@ int ocf_req_async_lock_wr(struct ocf_alock *c,
 int ocf_req_async_lock_rd(struct ocf_alock *c,
 		struct ocf_request *req, ocf_req_async_lock_cb cmpl);
 
+/**
+ * @brief Try to lock OCF request for read access without waiting
+ *
+ * @param c - cacheline concurrency private data
+ * @param req - OCF request
+ *
+ * @retval OCF_LOCK_ACQUIRED - OCF request has been locked
+ * @retval OCF_LOCK_NOT_ACQUIRED - no cache line has been locked and request
+ * was not added into waiting list
+ */
+int ocf_req_trylock_rd(struct ocf_alock *c, struct ocf_request *req);
+
 /**
  * @brief Unlock OCF request from write access
  *
@@ -111,6 +123,18 @@ void ocf_req_unlock_rd(struct ocf_alock *c,
 void ocf_req_unlock(struct ocf_alock *c,
 		struct ocf_request *req);
 
+/**
+ * @brief Unlock OCF request from its completion path
+ *
+ * Caller must not hold any other lock, so that requests waiting for released
+ * cache lines may be resumed inline on the caller's stack.
+ *
+ * @param c - cacheline concurrency private data
+ * @param req - OCF request
+ */
+void ocf_req_unlock_completed(struct ocf_alock *c,
+		struct ocf_request *req);
+
 /**
  * @Check if cache line is used.
  *
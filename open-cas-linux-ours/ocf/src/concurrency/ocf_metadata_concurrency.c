@@ -5,6 +5,7 @@
 
 #include "ocf_metadata_concurrency.h"
 #include "../metadata/metadata_misc.h"
+#include "../metadata/metadata.h"
 #include "../ocf_queue_priv.h"
 
 int ocf_metadata_concurrency_init(struct ocf_metadata_lock *metadata_lock)
@@ -19,11 +20,17 @@ int ocf_metadata_concurrency_init(struct ocf_metadata_lock *metadata_lock)
 
 	for (global_iter = 0; global_iter < OCF_NUM_GLOBAL_META_LOCKS;
 			global_iter++) {
-		err = env_rwsem_init(&metadata_lock->global[global_iter].sem);
-		if (err)
-			goto global_err;
+		env_atomic_set(&metadata_lock->global[global_iter].readers, 0);
 	}
 
+	env_atomic_set(&metadata_lock->excl.writer, 0);
+	env_atomic_set(&metadata_lock->excl.waiting, 0);
+	err = env_rwsem_init(&metadata_lock->excl.sem);
+	if (err)
+		goto global_err;
+
+	env_completion_init(&metadata_lock->excl.drained);
+
 	for (part_iter = 0; part_iter < OCF_USER_IO_CLASS_MAX; part_iter++) {
 		err = env_spinlock_init(&metadata_lock->partition[part_iter]);
 		if (err)
@@ -36,10 +43,10 @@ partition_err:
 	while (part_iter--)
 		env_spinlock_destroy(&metadata_lock->partition[part_iter]);
 
-global_err:
-	while (global_iter--)
-		env_rwsem_destroy(&metadata_lock->global[global_iter].sem);
+	env_completion_destroy(&metadata_lock->excl.drained);
+	env_rwsem_destroy(&metadata_lock->excl.sem);
 
+global_err:
 	while (lru_iter--)
 		env_rwlock_destroy(&metadata_lock->lru[lru_iter]);
 
@@ -56,8 +63,8 @@ void ocf_metadata_concurrency_deinit(struct ocf_metadata_lock *metadata_lock)
 	for (i = 0; i < OCF_NUM_LRU_LISTS; i++)
 		env_rwlock_destroy(&metadata_lock->lru[i]);
 
-	for (i = 0; i < OCF_NUM_GLOBAL_META_LOCKS; i++)
-		env_rwsem_destroy(&metadata_lock->global[i].sem);
+	env_completion_destroy(&metadata_lock->excl.drained);
+	env_rwsem_destroy(&metadata_lock->excl.sem);
 }
 
 int ocf_metadata_concurrency_attached_init(
@@ -69,13 +76,17 @@ int ocf_metadata_concurrency_attached_init(
 
 	metadata_lock->hash = env_vzalloc(sizeof(env_rwsem) *
 			hash_table_entries);
+	metadata_lock->hash_seq = env_vzalloc(sizeof(env_atomic) *
+			hash_table_entries);
 	metadata_lock->collision_pages = env_vzalloc(sizeof(env_rwsem) *
 			colision_table_pages);
-	if (!metadata_lock->hash ||
+	if (!metadata_lock->hash || !metadata_lock->hash_seq ||
 			!metadata_lock->collision_pages) {
 		env_vfree(metadata_lock->hash);
+		env_vfree(metadata_lock->hash_seq);
 		env_vfree(metadata_lock->collision_pages);
 		metadata_lock->hash = NULL;
+		metadata_lock->hash_seq = NULL;
 		metadata_lock->collision_pages = NULL;
 		return -OCF_ERR_NO_MEM;
 	}
@@ -129,6 +140,11 @@ void ocf_metadata_concurrency_attached_deinit(
 		metadata_lock->num_hash_entries = 0;
 	}
 
+	if (metadata_lock->hash_seq) {
+		env_vfree(metadata_lock->hash_seq);
+		metadata_lock->hash_seq = NULL;
+	}
+
 	if (metadata_lock->collision_pages) {
 		for (i = 0; i < metadata_lock->num_collision_pages; i++)
 			env_rwsem_destroy(&metadata_lock->collision_pages[i]);
@@ -138,71 +154,172 @@ void ocf_metadata_concurrency_attached_deinit(
 	}
 }
 
-void ocf_metadata_start_exclusive_access(
+size_t ocf_metadata_concurrency_size_of(
+		struct ocf_metadata_lock *metadata_lock)
+{
+	return sizeof(env_rwsem) * ((size_t)metadata_lock->num_hash_entries +
+			metadata_lock->num_collision_pages) +
+			sizeof(env_atomic) * metadata_lock->num_hash_entries;
+}
+
+/* Sequence counters let readers traverse hash buckets without taking any
+   lock. Counter is odd while the writer holds the lock and is bumped again
+   on release, so reader detects concurrent modification either by seeing
+   odd value or by seeing the value changed after the traversal. */
+static inline void ocf_metadata_seq_write_begin(env_atomic *seq)
+{
+	env_atomic_inc(seq);
+	env_smp_wmb();
+}
+
+static inline void ocf_metadata_seq_write_end(env_atomic *seq)
+{
+	env_smp_wmb();
+	env_atomic_inc(seq);
+}
+
+/* Global metadata lock is reader biased: shared access only increments
+   reader counter selected by lock_idx and checks that no writer is around.
+   Exclusive access raises the writer flag, which diverts new readers to
+   the writer semaphore, and then sleeps until the reader which drains all
+   reader counters completes excl.drained. */
+static uint32_t ocf_metadata_shared_count(
 		struct ocf_metadata_lock *metadata_lock)
 {
+	uint32_t count = 0;
 	unsigned i;
 
-	for (i = 0; i < OCF_NUM_GLOBAL_META_LOCKS; i++) {
-		env_rwsem_down_write(&metadata_lock->global[i].sem);
+	for (i = 0; i < OCF_NUM_GLOBAL_META_LOCKS; i++)
+		count += env_atomic_read(&metadata_lock->global[i].readers);
+
+	return count;
+}
+
+/* Drop reader count. If writer is waiting and this was the last reader,
+   wake the writer up. Waiting flag makes sure it is woken exactly once. */
+static inline void ocf_metadata_shared_put(
+		struct ocf_metadata_lock *metadata_lock,
+		struct ocf_metadata_global_lock *global)
+{
+	env_atomic_dec(&global->readers);
+	env_smp_mb();
+
+	if (likely(!env_atomic_read(&metadata_lock->excl.waiting)))
+		return;
+
+	if (ocf_metadata_shared_count(metadata_lock))
+		return;
+
+	if (env_atomic_cmpxchg(&metadata_lock->excl.waiting, 1, 0) == 1)
+		env_completion_complete(&metadata_lock->excl.drained);
+}
+
+void ocf_metadata_start_exclusive_access(
+		struct ocf_metadata_lock *metadata_lock)
+{
+	env_rwsem_down_write(&metadata_lock->excl.sem);
+
+	env_atomic_set(&metadata_lock->excl.writer, 1);
+	env_smp_mb();
+
+	if (ocf_metadata_shared_count(metadata_lock)) {
+		env_atomic_set(&metadata_lock->excl.waiting, 1);
+		env_smp_mb();
+
+		/* Readers might have drained before waiting flag was set -
+		   unless one of them already took the wakeup, don't sleep */
+		if (ocf_metadata_shared_count(metadata_lock) ||
+				env_atomic_cmpxchg(&metadata_lock->excl.waiting,
+						1, 0) != 1) {
+			env_completion_wait(&metadata_lock->excl.drained);
+		}
 	}
+
+	ocf_metadata_seq_write_begin(&metadata_lock->excl_seq);
 }
 
 int ocf_metadata_try_start_exclusive_access(
 		struct ocf_metadata_lock *metadata_lock)
 {
-	unsigned i;
 	int error;
 
-	for (i = 0; i < OCF_NUM_GLOBAL_META_LOCKS; i++) {
-		error =  env_rwsem_down_write_trylock(&metadata_lock->global[i].sem);
-		if (error)
-			break;
-	}
+	error = env_rwsem_down_write_trylock(&metadata_lock->excl.sem);
+	if (error)
+		return error;
 
-	if (error) {
-		while (i--) {
-			env_rwsem_up_write(&metadata_lock->global[i].sem);
-		}
+	env_atomic_set(&metadata_lock->excl.writer, 1);
+	env_smp_mb();
+
+	if (ocf_metadata_shared_count(metadata_lock)) {
+		env_atomic_set(&metadata_lock->excl.writer, 0);
+		env_rwsem_up_write(&metadata_lock->excl.sem);
+		return -OCF_ERR_NO_LOCK;
 	}
 
-	return error;
+	ocf_metadata_seq_write_begin(&metadata_lock->excl_seq);
+
+	return 0;
 }
 
 void ocf_metadata_end_exclusive_access(
 		struct ocf_metadata_lock *metadata_lock)
 {
-	unsigned i;
+	ocf_metadata_seq_write_end(&metadata_lock->excl_seq);
 
-	for (i = OCF_NUM_GLOBAL_META_LOCKS; i > 0; i--)
-	        env_rwsem_up_write(&metadata_lock->global[i - 1].sem);
+	env_smp_mb();
+	env_atomic_set(&metadata_lock->excl.writer, 0);
+	env_rwsem_up_write(&metadata_lock->excl.sem);
 }
 
-/* lock_idx determines which of underlying R/W locks is acquired for read. The goal
-   is to spread calls across all available underlying locks to reduce contention
-   on one single RW semaphor primitive. Technically any value is correct, but
-   picking wisely would allow for higher read througput:
-   * free running per-cpu counter sounds good,
-   * for rarely excercised code paths (e.g. management) any value would do.
+/* lock_idx determines which reader counter is incremented. Any value is
+   correct as long as the same one is passed to the unlock routine, but
+   readers running on the same CPU should pick the same counter to keep
+   it in the local cache (see ocf_metadata_concurrency_next_idx()).
 */
 void ocf_metadata_start_shared_access(
 		struct ocf_metadata_lock *metadata_lock,
 		unsigned lock_idx)
 {
-        env_rwsem_down_read(&metadata_lock->global[lock_idx].sem);
+	struct ocf_metadata_global_lock *global =
+			&metadata_lock->global[lock_idx];
+
+	env_atomic_inc(&global->readers);
+	env_smp_mb();
+
+	if (likely(!env_atomic_read(&metadata_lock->excl.writer)))
+		return;
+
+	/* Writer is pending - back off and wait until it is done */
+	ocf_metadata_shared_put(metadata_lock, global);
+
+	env_rwsem_down_read(&metadata_lock->excl.sem);
+	env_atomic_inc(&global->readers);
+	env_rwsem_up_read(&metadata_lock->excl.sem);
 }
 
 int ocf_metadata_try_start_shared_access(
 		struct ocf_metadata_lock *metadata_lock,
 		unsigned lock_idx)
 {
-	return env_rwsem_down_read_trylock(&metadata_lock->global[lock_idx].sem);
+	struct ocf_metadata_global_lock *global =
+			&metadata_lock->global[lock_idx];
+
+	env_atomic_inc(&global->readers);
+	env_smp_mb();
+
+	if (likely(!env_atomic_read(&metadata_lock->excl.writer)))
+		return 0;
+
+	ocf_metadata_shared_put(metadata_lock, global);
+
+	return -OCF_ERR_NO_LOCK;
 }
 
 void ocf_metadata_end_shared_access(struct ocf_metadata_lock *metadata_lock,
 		unsigned lock_idx)
 {
-        env_rwsem_up_read(&metadata_lock->global[lock_idx].sem);
+	env_smp_mb();
+	ocf_metadata_shared_put(metadata_lock, &metadata_lock->global[lock_idx]);
 }
 
 /* NOTE: Calling 'naked' lock/unlock requires caller to hold global metadata
@@ -218,12 +335,14 @@ static inline void ocf_hb_id_naked_lock(
 {
 	ENV_BUG_ON(hash >= metadata_lock->num_hash_entries);
 
-	if (rw == OCF_METADATA_WR)
+	if (rw == OCF_METADATA_WR) {
 		env_rwsem_down_write(&metadata_lock->hash[hash]);
-	else if (rw == OCF_METADATA_RD)
+		ocf_metadata_seq_write_begin(&metadata_lock->hash_seq[hash]);
+	} else if (rw == OCF_METADATA_RD) {
 		env_rwsem_down_read(&metadata_lock->hash[hash]);
-	else
+	} else {
 		ENV_BUG();
+	}
 }
 
 static inline void ocf_hb_id_naked_unlock(
@@ -232,12 +351,14 @@ static inline void ocf_hb_id_naked_unlock(
 {
 	ENV_BUG_ON(hash >= metadata_lock->num_hash_entries);
 
-	if (rw == OCF_METADATA_WR)
+	if (rw == OCF_METADATA_WR) {
+		ocf_metadata_seq_write_end(&metadata_lock->hash_seq[hash]);
 		env_rwsem_up_write(&metadata_lock->hash[hash]);
-	else if (rw == OCF_METADATA_RD)
+	} else if (rw == OCF_METADATA_RD) {
 		env_rwsem_up_read(&metadata_lock->hash[hash]);
-	else
+	} else {
 		ENV_BUG();
+	}
 }
 
 static int ocf_hb_id_naked_trylock(struct ocf_metadata_lock *metadata_lock,
@@ -250,6 +371,10 @@ static int ocf_hb_id_naked_trylock(struct ocf_metadata_lock *metadata_lock,
 	if (rw == OCF_METADATA_WR) {
 		result = env_rwsem_down_write_trylock(
 				&metadata_lock->hash[hash]);
+		if (!result) {
+			ocf_metadata_seq_write_begin(
+					&metadata_lock->hash_seq[hash]);
+		}
 	} else if (rw == OCF_METADATA_RD) {
 		result = env_rwsem_down_read_trylock(
 				&metadata_lock->hash[hash]);
@@ -457,10 +582,38 @@ bool ocf_req_hash_in_range(struct ocf_request *req,
 				hash <=  _MAX_HASH(req));
 }
 
+/* Min number of hash buckets in request to prefetch them before locking */
+#define OCF_HB_REQ_PREFETCH_MIN 4
+
+/*
+ * Issue prefetches for all request hash bucket locks (and sequence counters
+ * for write lock) and collision list heads, so that the cache misses overlap
+ * instead of being taken one by one while acquiring the locks. Hash values
+ * of consecutive core lines are consecutive, so for_each_req_hash_asc already
+ * visits each bucket once in ascending (deadlock safe) order - no separate
+ * sort or dedup pass is needed.
+ */
+static void ocf_hb_req_prefetch(struct ocf_request *req, int rw)
+{
+	struct ocf_metadata_lock *metadata_lock = &req->cache->metadata.lock;
+	ocf_cache_line_t hash;
+
+	if (_HASH_COUNT(req) < OCF_HB_REQ_PREFETCH_MIN)
+		return;
+
+	for_each_req_hash_asc(req, hash) {
+		env_prefetchw(&metadata_lock->hash[hash]);
+		if (rw == OCF_METADATA_WR)
+			env_prefetchw(&metadata_lock->hash_seq[hash]);
+		ocf_metadata_prefetch_hash(req->cache, hash);
+	}
+}
+
 void ocf_hb_req_prot_lock_rd(struct ocf_request *req)
 {
 	ocf_cache_line_t hash;
 
+	ocf_hb_req_prefetch(req, OCF_METADATA_RD);
 	ocf_metadata_start_shared_access(&req->cache->metadata.lock,
 			req->lock_idx);
 	for_each_req_hash_asc(req, hash) {
@@ -481,10 +634,50 @@ void ocf_hb_req_prot_unlock_rd(struct ocf_request *req)
 			req->lock_idx);
 }
 
+static uint32_t ocf_hb_req_seq_read(struct ocf_request *req, bool *busy)
+{
+	struct ocf_metadata_lock *metadata_lock = &req->cache->metadata.lock;
+	ocf_cache_line_t hash;
+	uint32_t seq, sum;
+
+	sum = env_atomic_read(&metadata_lock->excl_seq);
+	*busy = sum & 1;
+
+	for_each_req_hash_asc(req, hash) {
+		seq = env_atomic_read(&metadata_lock->hash_seq[hash]);
+		*busy |= seq & 1;
+		sum += seq;
+	}
+
+	return sum;
+}
+
+/* Counters only grow, so the sum over request hash buckets changes whenever
+   any of the buckets has been write locked in the meantime. */
+bool ocf_hb_req_seq_begin(struct ocf_request *req, uint32_t *seq)
+{
+	bool busy;
+
+	*seq = ocf_hb_req_seq_read(req, &busy);
+	env_smp_rmb();
+
+	return !busy;
+}
+
+bool ocf_hb_req_seq_retry(struct ocf_request *req, uint32_t seq)
+{
+	bool busy;
+
+	env_smp_rmb();
+
+	return ocf_hb_req_seq_read(req, &busy) != seq;
+}
+
 void ocf_hb_req_prot_lock_wr(struct ocf_request *req)
 {
 	ocf_cache_line_t hash;
 
+	ocf_hb_req_prefetch(req, OCF_METADATA_WR);
 	ocf_metadata_start_shared_access(&req->cache->metadata.lock,
 			req->lock_idx);
 	for_each_req_hash_asc(req, hash) {
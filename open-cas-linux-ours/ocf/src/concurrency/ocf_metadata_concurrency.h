@@ -12,9 +12,16 @@
 #define OCF_METADATA_RD 0
 #define OCF_METADATA_WR 1
 
+/* Shared access index is derived from current execution context, so that
+   readers running on the same CPU share a reader counter cache line which
+   is not bounced between CPUs */
 static inline unsigned ocf_metadata_concurrency_next_idx(ocf_queue_t q)
 {
-	return q->lock_idx++ % OCF_NUM_GLOBAL_META_LOCKS;
+	unsigned ctx = env_get_execution_context();
+
+	env_put_execution_context(ctx);
+
+	return ctx % OCF_NUM_GLOBAL_META_LOCKS;
 }
 
 int ocf_metadata_concurrency_init(struct ocf_metadata_lock *metadata_lock);
@@ -28,6 +35,9 @@ int ocf_metadata_concurrency_attached_init(
 void ocf_metadata_concurrency_attached_deinit(
 		struct ocf_metadata_lock *metadata_lock);
 
+size_t ocf_metadata_concurrency_size_of(
+		struct ocf_metadata_lock *metadata_lock);
+
 static inline void ocf_metadata_lru_wr_lock(
 		struct ocf_metadata_lock *metadata_lock, unsigned ev_list)
 {
@@ -168,6 +178,12 @@ void ocf_hb_req_prot_lock_wr(struct ocf_request *req);
 void ocf_hb_req_prot_unlock_wr(struct ocf_request *req);
 void ocf_hb_req_prot_lock_upgrade(struct ocf_request *req);
 
+/* optimistic (lockless) read of request hash buckets - returns false from
+   begin if any of the buckets is being modified, true from retry if any
+   of them has been modified since begin */
+bool ocf_hb_req_seq_begin(struct ocf_request *req, uint32_t *seq);
+bool ocf_hb_req_seq_retry(struct ocf_request *req, uint32_t seq);
+
 /* collision table page lock interface */
 void ocf_collision_start_shared_access(struct ocf_metadata_lock *metadata_lock,
 		uint32_t page);
@@ -116,9 +116,49 @@ const struct ocf_io_if *ocf_get_io_if(ocf_req_cache_mode_t req_cache_mode)
 	return cache_mode_io_if_map[req_cache_mode];
 }
 
+/*
+ * Select lane to dispatch next request from. Lanes are scanned in priority
+ * order and each lane may dispatch up to its weight requests per round.
+ * New round begins when all lanes with pending requests used up their credit.
+ */
+static struct ocf_queue_lane *ocf_engine_select_lane(ocf_queue_t q)
+{
+	struct ocf_queue_lane *lane;
+	bool pending = false;
+	int i;
+
+	for (i = 0; i < ocf_queue_lane_max; i++) {
+		lane = &q->lanes[i];
+
+		if (list_empty(&lane->io_list))
+			continue;
+
+		if (lane->weight == OCF_QUEUE_LANE_WEIGHT_STRICT || lane->credit)
+			return lane;
+
+		pending = true;
+	}
+
+	if (!pending)
+		return NULL;
+
+	for (i = 0; i < ocf_queue_lane_max; i++)
+		q->lanes[i].credit = q->lanes[i].weight;
+
+	for (i = 0; i < ocf_queue_lane_max; i++) {
+		lane = &q->lanes[i];
+
+		if (!list_empty(&lane->io_list))
+			return lane;
+	}
+
+	return NULL;
+}
+
 struct ocf_request *ocf_engine_pop_req(ocf_queue_t q)
 {
 	unsigned long lock_flags = 0;
+	struct ocf_queue_lane *lane;
 	struct ocf_request *req;
 
 	OCF_CHECK_NULL(q);
@@ -126,7 +166,8 @@ struct ocf_request *ocf_engine_pop_req(ocf_queue_t q)
 	/* LOCK */
 	env_spinlock_lock_irqsave(&q->io_list_lock, lock_flags);
 
-	if (list_empty(&q->io_list)) {
+	lane = ocf_engine_select_lane(q);
+	if (!lane) {
 		/* No items on the list */
 		env_spinlock_unlock_irqrestore(&q->io_list_lock,
 				lock_flags);
@@ -134,7 +175,10 @@ struct ocf_request *ocf_engine_pop_req(ocf_queue_t q)
 	}
 
 	/* Get the first request and remove it from the list */
-	req = list_first_entry(&q->io_list, struct ocf_request, list);
+	req = list_first_entry(&lane->io_list, struct ocf_request, list);
+
+	if (lane->credit)
+		lane->credit--;
 
 	env_atomic_dec(&q->io_no);
 	list_del(&req->list);
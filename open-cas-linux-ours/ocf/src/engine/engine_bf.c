@@ -56,11 +56,19 @@ static void _ocf_backfill_complete(struct ocf_request *req, int error)
 
 	backfill_queue_dec_unblock(req->cache);
 
-	/* We must free the pages we have allocated */
-	ctx_data_secure_erase(cache->owner, req->data);
-	ctx_data_munlock(cache->owner, req->data);
-	ctx_data_free(cache->owner, req->data);
-	req->data = NULL;
+	if (req->cp_data) {
+		/* We must free the pages we have allocated */
+		ctx_data_secure_erase(cache->owner, req->data);
+		ctx_data_munlock(cache->owner, req->data);
+		ctx_data_free(cache->owner, req->data);
+		req->data = NULL;
+		req->cp_data = NULL;
+	} else {
+		/* Backfilled from user pages - data read from core is valid
+		 * regardless of backfill result, so user request succeeds
+		 */
+		req->complete(req, 0);
+	}
 
 	if (req->error) {
 		ocf_core_stats_cache_error_update(req->core, OCF_WRITE);
@@ -82,7 +90,8 @@ static int _ocf_backfill_do(struct ocf_request *req)
 	/* There will be #reqs_to_issue completions */
 	env_atomic_set(&req->req_remaining, reqs_to_issue);
 
-	req->data = req->cp_data;
+	if (req->cp_data)
+		req->data = req->cp_data;
 
 	ocf_submit_cache_reqs(req->cache, req, OCF_WRITE, 0, req->byte_length,
 				reqs_to_issue, _ocf_backfill_complete);
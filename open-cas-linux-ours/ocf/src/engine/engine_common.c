@@ -72,6 +72,54 @@ void ocf_engine_lookup_map_entry(struct ocf_cache *cache,
 	}
 }
 
+/* Longest collision chain walked without hash bucket lock. Chains are
+ * a few entries long on average, so hitting this limit means either a very
+ * unlucky bucket or a chain being modified under our feet - in both cases
+ * locked lookup takes over.
+ */
+#define OCF_ENGINE_OPTIMISTIC_CHAIN_MAX 64
+
+/* Variant of ocf_engine_lookup_map_entry() which tolerates collision table
+ * being modified concurrently. Returns false if inconsistent chain has been
+ * observed.
+ */
+static bool ocf_engine_lookup_map_entry_optimistic(struct ocf_cache *cache,
+		struct ocf_map_info *entry, ocf_core_id_t core_id,
+		uint64_t core_line)
+{
+	ocf_cache_line_t entries = cache->device->collision_table_entries;
+	ocf_cache_line_t line;
+	ocf_core_id_t curr_core_id;
+	uint64_t curr_core_line;
+	unsigned steps = 0;
+
+	entry->hash = ocf_metadata_hash_func(cache, core_line, core_id);
+	entry->status = LOOKUP_MISS;
+	entry->coll_idx = entries;
+	entry->core_line = core_line;
+	entry->core_id = core_id;
+
+	line = ocf_metadata_get_hash(cache, entry->hash);
+
+	while (line != entries) {
+		if (line > entries || steps++ == OCF_ENGINE_OPTIMISTIC_CHAIN_MAX)
+			return false;
+
+		ocf_metadata_get_core_info(cache, line, &curr_core_id,
+				&curr_core_line);
+
+		if (core_id == curr_core_id && curr_core_line == core_line) {
+			entry->coll_idx = line;
+			entry->status = LOOKUP_HIT;
+			break;
+		}
+
+		line = ocf_metadata_get_collision_next(cache, line);
+	}
+
+	return true;
+}
+
 static inline int _ocf_engine_check_map_entry(struct ocf_cache *cache,
 		struct ocf_map_info *entry, ocf_core_id_t core_id)
 {
@@ -249,6 +297,63 @@ void ocf_engine_traverse(struct ocf_request *req)
 	ocf_engine_set_hot(req);
 }
 
+bool ocf_engine_traverse_optimistic_rd(struct ocf_request *req)
+{
+	struct ocf_cache *cache = req->cache;
+	ocf_core_id_t core_id = ocf_core_get_id(req->core);
+	uint64_t core_line;
+	uint32_t seq, i;
+
+	OCF_DEBUG_TRACE(req->cache);
+
+	if (!ocf_hb_req_seq_begin(req, &seq))
+		return false;
+
+	ocf_req_clear_info(req);
+
+	for (i = 0, core_line = req->core_line_first;
+			core_line <= req->core_line_last; core_line++, i++) {
+		struct ocf_map_info *entry = &(req->map[i]);
+
+		if (!ocf_engine_lookup_map_entry_optimistic(cache, entry,
+				core_id, core_line)) {
+			goto retry_locked;
+		}
+
+		if (entry->status != LOOKUP_HIT)
+			goto retry_locked;
+
+		ocf_engine_update_req_info(cache, req, i);
+	}
+
+	if (!ocf_engine_is_hit(req))
+		goto retry_locked;
+
+	if (ocf_req_trylock_rd(ocf_cache_line_concurrency(cache), req) !=
+			OCF_LOCK_ACQUIRED) {
+		goto retry_locked;
+	}
+
+	/* Cache lines are locked now, so if nobody remapped request hash
+	 * buckets in the meantime, the lookup result is stable.
+	 */
+	if (ocf_hb_req_seq_retry(req, seq)) {
+		ocf_req_unlock_rd(ocf_cache_line_concurrency(cache), req);
+		goto retry_locked;
+	}
+
+	ocf_engine_set_hot(req);
+
+	return true;
+
+retry_locked:
+	/* Partition check might have been done against torn metadata */
+	for (i = 0; i < req->core_line_count; i++)
+		req->map[i].re_part = false;
+
+	return false;
+}
+
 int ocf_engine_check(struct ocf_request *req)
 {
 	int result = 0;
@@ -584,16 +689,35 @@ void ocf_engine_update_request_stats(struct ocf_request *req)
 			req->info.hit_no, req->core_line_count);
 }
 
+static inline struct ocf_queue_lane *ocf_engine_req_lane(
+		struct ocf_request *req)
+{
+	ocf_queue_t q = req->io_queue;
+
+	if (!req->info.internal) {
+		return &q->lanes[req->rw == OCF_WRITE ?
+				ocf_queue_lane_user_write :
+				ocf_queue_lane_user_read];
+	}
+
+	if (q == req->cache->mngt_queue)
+		return &q->lanes[ocf_queue_lane_mngt];
+
+	return &q->lanes[ocf_queue_lane_background];
+}
+
 void ocf_engine_push_req_back(struct ocf_request *req, bool allow_sync)
 {
 	ocf_cache_t cache = req->cache;
 	ocf_queue_t q = NULL;
+	struct ocf_queue_lane *lane;
 	unsigned long lock_flags = 0;
 
 	INIT_LIST_HEAD(&req->list);
 
 	ENV_BUG_ON(!req->io_queue);
 	q = req->io_queue;
+	lane = ocf_engine_req_lane(req);
 
 	if (!req->info.internal) {
 		env_atomic_set(&cache->last_access_ms,
@@ -602,7 +726,7 @@ void ocf_engine_push_req_back(struct ocf_request *req, bool allow_sync)
 
 	env_spinlock_lock_irqsave(&q->io_list_lock, lock_flags);
 
-	list_add_tail(&req->list, &q->io_list);
+	list_add_tail(&req->list, &lane->io_list);
 	env_atomic_inc(&q->io_no);
 
 	env_spinlock_unlock_irqrestore(&q->io_list_lock, lock_flags);
@@ -618,12 +742,14 @@ void ocf_engine_push_req_front(struct ocf_request *req, bool allow_sync)
 {
 	ocf_cache_t cache = req->cache;
 	ocf_queue_t q = NULL;
+	struct ocf_queue_lane *lane;
 	unsigned long lock_flags = 0;
 
 	ENV_BUG_ON(!req->io_queue);
 	INIT_LIST_HEAD(&req->list);
 
 	q = req->io_queue;
+	lane = ocf_engine_req_lane(req);
 
 	if (!req->info.internal) {
 		env_atomic_set(&cache->last_access_ms,
@@ -632,7 +758,7 @@ void ocf_engine_push_req_front(struct ocf_request *req, bool allow_sync)
 
 	env_spinlock_lock_irqsave(&q->io_list_lock, lock_flags);
 
-	list_add(&req->list, &q->io_list);
+	list_add(&req->list, &lane->io_list);
 	env_atomic_inc(&q->io_no);
 
 	env_spinlock_unlock_irqrestore(&q->io_list_lock, lock_flags);
@@ -713,13 +839,99 @@ static const struct ocf_io_if _io_if_refresh = {
 	.write = _ocf_engine_refresh,
 };
 
+/* Maximum number of requests resumed inline on a single execution context
+ * at a time. Inline resume executes next engine step on the stack of the
+ * unlocking context, which may in turn complete and resume other requests,
+ * so the depth of such chains must be bounded.
+ */
+#define OCF_ENGINE_INLINE_RESUME_MAX_DEPTH 4
+
+struct ocf_engine_inline_resume_depth {
+	env_atomic value;
+} __attribute__((aligned(64)));
+
+int ocf_engine_inline_resume_init(ocf_cache_t cache)
+{
+	cache->inline_resume_depth = env_vzalloc(
+			env_get_execution_context_count() *
+			sizeof(*cache->inline_resume_depth));
+
+	return cache->inline_resume_depth ? 0 : -OCF_ERR_NO_MEM;
+}
+
+void ocf_engine_inline_resume_deinit(ocf_cache_t cache)
+{
+	env_vfree(cache->inline_resume_depth);
+	cache->inline_resume_depth = NULL;
+}
+
+/*
+ * Execution context is not held while engine step runs, as the step may
+ * sleep. Depth is returned to the same counter it was taken from, so if the
+ * step migrates, the old context is only more conservative until it ends.
+ */
+static bool ocf_engine_inline_resume_get(struct ocf_request *req,
+		unsigned *ctx)
+{
+	ocf_cache_t cache = req->cache;
+	env_atomic *depth;
+
+	if (!cache->inline_resume || !cache->inline_resume_depth)
+		return false;
+
+	/* Engine step may sleep, so it can't be executed in interrupt */
+	if (env_in_interrupt())
+		return false;
+
+	*ctx = env_get_execution_context();
+	env_put_execution_context(*ctx);
+
+	depth = &cache->inline_resume_depth[*ctx].value;
+	if (env_atomic_inc_return(depth) > OCF_ENGINE_INLINE_RESUME_MAX_DEPTH) {
+		env_atomic_dec(depth);
+		return false;
+	}
+
+	return true;
+}
+
+static void ocf_engine_inline_resume_put(ocf_cache_t cache, unsigned ctx)
+{
+	env_atomic_dec(&cache->inline_resume_depth[ctx].value);
+}
+
 void ocf_engine_on_resume(struct ocf_request *req)
 {
+	ocf_queue_t q = req->io_queue;
+	ocf_cache_t cache = req->cache;
+	bool unlocked = req->info.resume_unlocked;
+	unsigned ctx;
+
 	ENV_BUG_ON(req->priv);
 	OCF_CHECK_NULL(req->io_if);
 
 	/* Exchange IO interface */
 	req->priv = (void *)req->io_if;
+	req->info.resume_unlocked = false;
+
+	/* Only lock released from completion path, with no other locks held,
+	 * allows running the engine step right away */
+	if (unlocked && ocf_engine_inline_resume_get(req, &ctx)) {
+		OCF_DEBUG_RQ(req, "On resume inline");
+
+		/* Request may complete and drop the last reference to its
+		 * queue (and so to the cache) before the step returns */
+		ocf_queue_get(q);
+
+		req->error = 0;
+		_ocf_engine_refresh(req);
+
+		/* NOTE: do not dereference @req past this line, it might
+		 * be already completed and deallocated */
+		ocf_engine_inline_resume_put(cache, ctx);
+		ocf_queue_put(q);
+		return;
+	}
 
 	OCF_DEBUG_RQ(req, "On resume");
 
@@ -243,6 +243,22 @@ int ocf_engine_prepare_clines(struct ocf_request *req);
  */
 void ocf_engine_traverse(struct ocf_request *req);
 
+/**
+ * @brief Traverse OCF request and read lock its cache lines without taking
+ *	hash bucket locks
+ *
+ * @note Collision metadata is read under hash bucket sequence counters. Any
+ * concurrent modification of request hash buckets is detected after cache
+ * lines are locked, in which case locks are dropped and caller is expected
+ * to fall back to ocf_engine_traverse() under hash bucket locks.
+ *
+ * @param req OCF request
+ *
+ * @retval true request is a full hit and all its cache lines are read locked
+ * @retval false no lock is held, request map needs to be traversed again
+ */
+bool ocf_engine_traverse_optimistic_rd(struct ocf_request *req);
+
 /**
  * @brief Check if OCF request mapping is still valid
  *
@@ -316,4 +332,8 @@ void inc_fallback_pt_error_counter(ocf_cache_t cache);
 
 void ocf_engine_on_resume(struct ocf_request *req);
 
+int ocf_engine_inline_resume_init(ocf_cache_t cache);
+
+void ocf_engine_inline_resume_deinit(ocf_cache_t cache);
+
 #endif /* ENGINE_COMMON_H_ */
@@ -147,7 +147,7 @@ static void _ocf_discard_step_complete(struct ocf_request *req, int error)
 	OCF_DEBUG_RQ(req, "Completion");
 
 	/* Release WRITE lock of request */
-	ocf_req_unlock_wr(ocf_cache_line_concurrency(req->cache), req);
+	ocf_req_unlock_completed(ocf_cache_line_concurrency(req->cache), req);
 
 	if (req->error) {
 		ocf_metadata_error(req->cache);
@@ -53,7 +53,7 @@ static void _ocf_read_fast_complete(struct ocf_request *req, int error)
     }
     else
     {
-        ocf_req_unlock(ocf_cache_line_concurrency(req->cache), req);
+        ocf_req_unlock_completed(ocf_cache_line_concurrency(req->cache), req);
 
         /* Complete request */
         req->complete(req, req->error);
@@ -126,6 +126,27 @@ int ocf_read_fast(struct ocf_request *req)
     /*- Metadata RD access -----------------------------------------------*/
 
     ocf_req_hash(req);
+
+#if OCF_CONFIG_OPTIMISTIC_LOOKUP
+    /* Try read hit without touching any hash bucket lock */
+    if (ocf_engine_traverse_optimistic_rd(req))
+    {
+        if (ocf_user_part_has_space(req))
+        {
+            OCF_DEBUG_RQ(req, "Fast path success (optimistic)");
+            ocf_io_start(&req->ioi.io);
+            _ocf_read_fast_do(req);
+
+            /* Put OCF request - decrease reference counter */
+            ocf_req_put(req);
+
+            return OCF_FAST_PATH_YES;
+        }
+
+        ocf_req_unlock_rd(ocf_cache_line_concurrency(req->cache), req);
+    }
+#endif
+
     ocf_hb_req_prot_lock_rd(req);
 
     /* Traverse request to cache if there is hit */
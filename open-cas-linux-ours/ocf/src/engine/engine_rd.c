@@ -44,7 +44,7 @@ static void _ocf_read_generic_hit_complete(struct ocf_request *req, int error)
 			ocf_core_stats_cache_error_update(req->core, OCF_READ);
 			ocf_engine_push_req_front_pt(req);
 		} else {
-			ocf_req_unlock(c, req);
+			ocf_req_unlock_completed(c, req);
 
 			/* Complete request */
 			req->complete(req, req->error);
@@ -81,8 +81,10 @@ static void _ocf_read_generic_miss_complete(struct ocf_request *req, int error)
 			req->info.core_error = 1;
 			ocf_core_stats_core_error_update(req->core, OCF_READ);
 
-			ctx_data_free(cache->owner, req->cp_data);
-			req->cp_data = NULL;
+			if (req->cp_data) {
+				ctx_data_free(cache->owner, req->cp_data);
+				req->cp_data = NULL;
+			}
 
 			/* Invalidate metadata */
 			ocf_engine_invalidate(req);
@@ -90,6 +92,14 @@ static void _ocf_read_generic_miss_complete(struct ocf_request *req, int error)
 			return;
 		}
 
+		if (!req->cp_data) {
+			/* Backfill from user pages, request is completed
+			 * once data is written to cache
+			 */
+			ocf_engine_backfill(req);
+			return;
+		}
+
 		/* Copy pages to copy vec, since this is the one needed
 		 * by the above layer
 		 */
@@ -118,14 +128,16 @@ static inline void _ocf_read_generic_submit_miss(struct ocf_request *req)
 
 	env_atomic_set(&req->req_remaining, 1);
 
-	req->cp_data = ctx_data_alloc(cache->owner,
-			BYTES_TO_PAGES(req->byte_length));
-	if (!req->cp_data)
-		goto err_alloc;
+	if (cache->backfill.mode == ocf_backfill_mode_copy) {
+		req->cp_data = ctx_data_alloc(cache->owner,
+				BYTES_TO_PAGES(req->byte_length));
+		if (!req->cp_data)
+			goto err_alloc;
 
-	ret = ctx_data_mlock(cache->owner, req->cp_data);
-	if (ret)
-		goto err_alloc;
+		ret = ctx_data_mlock(cache->owner, req->cp_data);
+		if (ret)
+			goto err_alloc;
+	}
 
 	/* Submit read request to core device. */
 	ocf_submit_volume_req(&req->core->volume, req,
@@ -61,7 +61,7 @@ static void _ocf_write_wb_io_flush_metadata(struct ocf_request *req, int error)
 	if (req->error)
 		ocf_engine_error(req, true, "Failed to write data to cache");
 
-	ocf_req_unlock_wr(ocf_cache_line_concurrency(req->cache), req);
+	ocf_req_unlock_completed(ocf_cache_line_concurrency(req->cache), req);
 
 	req->complete(req, req->error);
 
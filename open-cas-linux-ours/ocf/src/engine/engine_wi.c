@@ -25,7 +25,7 @@ static const struct ocf_io_if _io_if_wi_update_metadata = {
 
 int _ocf_write_wi_next_pass(struct ocf_request *req)
 {
-	ocf_req_unlock_wr(ocf_cache_line_concurrency(req->cache), req);
+	ocf_req_unlock_completed(ocf_cache_line_concurrency(req->cache), req);
 
 	if (req->wi_second_pass) {
 		req->complete(req, req->error);
@@ -75,7 +75,7 @@ static void _ocf_write_wi_io_flush_metadata(struct ocf_request *req, int error)
 	if (req->error)
 		ocf_engine_error(req, true, "Failed to write data to cache");
 
-	ocf_req_unlock_wr(ocf_cache_line_concurrency(req->cache), req);
+	ocf_req_unlock_completed(ocf_cache_line_concurrency(req->cache), req);
 
 	req->complete(req, req->error);
 
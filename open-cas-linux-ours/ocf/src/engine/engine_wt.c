@@ -64,7 +64,7 @@ static void _ocf_write_wt_do_flush_metadata_compl(struct ocf_request *req,
 	if (req->error)
 		ocf_engine_error(req, true, "Failed to write data to cache");
 
-	ocf_req_unlock_wr(ocf_cache_line_concurrency(req->cache), req);
+	ocf_req_unlock_completed(ocf_cache_line_concurrency(req->cache), req);
 
 	req->complete(req, req->info.core_error ? req->error : 0);
 
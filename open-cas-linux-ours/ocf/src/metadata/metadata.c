@@ -15,6 +15,7 @@
 #include "../concurrency/ocf_concurrency.h"
 #include "../ocf_def_priv.h"
 #include "../ocf_priv.h"
+#include "../ocf_lru.h"
 #include "../utils/utils_cache_line.h"
 #include "../utils/utils_io.h"
 #include "../utils/utils_pipeline.h"
@@ -916,6 +917,35 @@ size_t ocf_metadata_size_of(struct ocf_cache *cache)
 
 	return size;
 }
+
+void ocf_metadata_get_memory_footprint(struct ocf_cache *cache,
+		struct ocf_cache_memory_footprint *footprint)
+{
+	struct ocf_metadata_ctrl *ctrl = cache->metadata.priv;
+	uint64_t size[metadata_segment_max];
+	uint32_t i;
+
+	for (i = 0; i < metadata_segment_max; i++)
+		size[i] = ocf_metadata_raw_size_of(cache, &ctrl->raw_desc[i]);
+
+	footprint->superblock = size[metadata_segment_sb_config] +
+			size[metadata_segment_sb_runtime] +
+			size[metadata_segment_reserved];
+	footprint->partitions = size[metadata_segment_part_config] +
+			size[metadata_segment_part_runtime];
+	footprint->cores = size[metadata_segment_core_config] +
+			size[metadata_segment_core_runtime] +
+			size[metadata_segment_core_uuid];
+	footprint->cleaning = size[metadata_segment_cleaning];
+	footprint->lru = size[metadata_segment_lru];
+	footprint->collision = size[metadata_segment_collision];
+	footprint->list_info = size[metadata_segment_list_info];
+	footprint->hash = size[metadata_segment_hash];
+
+	footprint->cache_line_locks = ocf_cache_line_concurrency_size_of(cache);
+	footprint->metadata_locks = ocf_metadata_concurrency_size_of(
+			&cache->metadata.lock);
+}
 /*******************************************************************************
  * RESERVED AREA
  ******************************************************************************/
@@ -1032,6 +1062,9 @@ void ocf_metadata_flush_all(ocf_cache_t cache,
 
 	OCF_DEBUG_TRACE(cache);
 
+	/* Persisted partition occupancy must include pending deltas */
+	ocf_lru_occupancy_sync(cache);
+
 	result = ocf_pipeline_create(&pipeline, cache,
 			&ocf_metadata_flush_all_pipeline_props);
 	if (result)
@@ -1429,7 +1462,7 @@ void ocf_metadata_get_core_and_part_id(struct ocf_cache *cache,
 	ENV_BUG_ON(!collision || !info);
 
 	if (core_id)
-		*core_id = collision->core_id;
+		*core_id = ocf_metadata_map_get_core_id(collision);
 	if (part_id)
 		*part_id = info->partition_id;
 }
@@ -1463,6 +1496,19 @@ void ocf_metadata_set_hash(struct ocf_cache *cache, ocf_cache_line_t index,
 			&(ctrl->raw_desc[metadata_segment_hash]), index) = line;
 }
 
+/*
+ * Hash Table - Prefetch collision list head
+ */
+void ocf_metadata_prefetch_hash(struct ocf_cache *cache,
+		ocf_cache_line_t index)
+{
+	struct ocf_metadata_ctrl *ctrl
+		= (struct ocf_metadata_ctrl *) cache->metadata.priv;
+
+	env_prefetch(ocf_metadata_raw_rd_access(cache,
+			&(ctrl->raw_desc[metadata_segment_hash]), index));
+}
+
 /*******************************************************************************
  *  Bitmap status
  ******************************************************************************/
@@ -91,6 +91,18 @@ void ocf_metadata_deinit_variable_size(struct ocf_cache *cache);
  */
 size_t ocf_metadata_size_of(struct ocf_cache *cache);
 
+/**
+ * @brief Get memory footprint broken down per metadata segment
+ *
+ * Fills segment and lock related fields of footprint, policy runtime
+ * contexts and total are left untouched.
+ *
+ * @param cache - Cache instance
+ * @param footprint - Memory footprint to be filled
+ */
+void ocf_metadata_get_memory_footprint(struct ocf_cache *cache,
+		struct ocf_cache_memory_footprint *footprint);
+
 /**
  * @brief Handle metadata error
  *
@@ -197,6 +209,9 @@ ocf_metadata_get_hash(struct ocf_cache *cache, ocf_cache_line_t index);
 void ocf_metadata_set_hash(struct ocf_cache *cache,
 		ocf_cache_line_t index, ocf_cache_line_t line);
 
+void ocf_metadata_prefetch_hash(struct ocf_cache *cache,
+		ocf_cache_line_t index);
+
 struct ocf_metadata_load_properties {
 	enum ocf_metadata_shutdown_status shutdown_status;
 	uint8_t dirty_flushed;
@@ -23,6 +23,46 @@ struct ocf_metadata_list_info {
  * @brief Metadata map structure
  */
 
+#if OCF_CONFIG_COMPACT_METADATA
+
+#define OCF_METADATA_CORE_LINE_BITS 48
+#define OCF_METADATA_CORE_LINE_MASK ((1ULL << OCF_METADATA_CORE_LINE_BITS) - 1)
+#define OCF_METADATA_CORE_LINE_MAX (OCF_METADATA_CORE_LINE_MASK - 1)
+
+struct ocf_metadata_map {
+	uint64_t core_info;
+		/*!<  Core line (low 48 bits) and core id (high 16 bits) */
+
+	uint8_t status[];
+		/*!<  Entry status structure e.g. valid, dirty...*/
+} __attribute__((packed));
+
+static inline ocf_core_id_t ocf_metadata_map_get_core_id(
+		const struct ocf_metadata_map *map)
+{
+	return map->core_info >> OCF_METADATA_CORE_LINE_BITS;
+}
+
+static inline uint64_t ocf_metadata_map_get_core_line(
+		const struct ocf_metadata_map *map)
+{
+	uint64_t core_line = map->core_info & OCF_METADATA_CORE_LINE_MASK;
+
+	/* All ones marks unmapped line, same as ULLONG_MAX in regular format */
+	return core_line == OCF_METADATA_CORE_LINE_MASK ? ULLONG_MAX : core_line;
+}
+
+static inline void ocf_metadata_map_set_core(struct ocf_metadata_map *map,
+		ocf_core_id_t core_id, uint64_t core_line)
+{
+	map->core_info = ((uint64_t)core_id << OCF_METADATA_CORE_LINE_BITS) |
+			OCF_MIN(core_line, OCF_METADATA_CORE_LINE_MASK);
+}
+
+#else
+
+#define OCF_METADATA_CORE_LINE_MAX (ULLONG_MAX - 1)
+
 struct ocf_metadata_map {
 	uint64_t core_line;
 		/*!<  Core line addres on cache mapped by this strcture */
@@ -34,6 +74,27 @@ struct ocf_metadata_map {
 		/*!<  Entry status structure e.g. valid, dirty...*/
 } __attribute__((packed));
 
+static inline ocf_core_id_t ocf_metadata_map_get_core_id(
+		const struct ocf_metadata_map *map)
+{
+	return map->core_id;
+}
+
+static inline uint64_t ocf_metadata_map_get_core_line(
+		const struct ocf_metadata_map *map)
+{
+	return map->core_line;
+}
+
+static inline void ocf_metadata_map_set_core(struct ocf_metadata_map *map,
+		ocf_core_id_t core_id, uint64_t core_line)
+{
+	map->core_id = core_id;
+	map->core_line = core_line;
+}
+
+#endif
+
 void ocf_metadata_set_collision_info(
 		struct ocf_cache *cache, ocf_cache_line_t line,
 		ocf_cache_line_t next, ocf_cache_line_t prev);
@@ -24,9 +24,9 @@ void ocf_metadata_get_core_info(struct ocf_cache *cache,
 	ENV_BUG_ON(!collision);
 
 	if (core_id)
-		*core_id = collision->core_id;
+		*core_id = ocf_metadata_map_get_core_id(collision);
 	if (core_sector)
-		*core_sector = collision->core_line;
+		*core_sector = ocf_metadata_map_get_core_line(collision);
 }
 
 void ocf_metadata_set_core_info(struct ocf_cache *cache,
@@ -41,8 +41,7 @@ void ocf_metadata_set_core_info(struct ocf_cache *cache,
 			&(ctrl->raw_desc[metadata_segment_collision]), line);
 
 	if (collision) {
-		collision->core_id = core_id;
-		collision->core_line = core_sector;
+		ocf_metadata_map_set_core(collision, core_id, core_sector);
 	} else {
 		ocf_metadata_error(cache);
 	}
@@ -59,7 +58,7 @@ ocf_core_id_t ocf_metadata_get_core_id(struct ocf_cache *cache,
 			&(ctrl->raw_desc[metadata_segment_collision]), line);
 
 	if (collision)
-		return collision->core_id;
+		return ocf_metadata_map_get_core_id(collision);
 
 	ocf_metadata_error(cache);
 	return OCF_CORE_MAX;
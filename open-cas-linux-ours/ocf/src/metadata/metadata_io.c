@@ -196,6 +196,11 @@ static void metadata_io_req_fill(struct metadata_io_request *m_req)
 	struct metadata_io_request_asynch *a_req = m_req->asynch;
 	int i;
 
+	/* Zeroing write - buffer was zeroed on allocation and is never
+	 * written, so there is nothing to fill */
+	if (!a_req->on_meta_fill)
+		return;
+
 	for (i = 0; i < m_req->count; i++) {
 		a_req->on_meta_fill(cache, m_req->data,
 			m_req->page + i, m_req->context);
@@ -432,6 +437,7 @@ static int metadata_io_i_asynch(ocf_cache_t cache, ocf_queue_t queue, int dir,
 	uint32_t max_count = metadata_io_max_page(cache);
 	uint32_t io_count = OCF_DIV_ROUND_UP(count, max_count);
 	uint32_t req_count = OCF_MIN(io_count, METADATA_IO_REQS_LIMIT);
+	uint32_t data_pages;
 	int i;
 	struct env_mpool *mio_allocator = cache->owner->resources.mio;
 
@@ -476,8 +482,11 @@ static int metadata_io_i_asynch(ocf_cache_t cache, ocf_queue_t queue, int dir,
 		 * max_count, for last we can allocate data smaller that
 		 * max_count as we are sure it will never be resubmitted.
 		 */
-		m_req->data = ctx_data_alloc(cache->owner,
-				OCF_MIN(max_count, count - i * max_count));
+		data_pages = OCF_MIN(max_count, count - i * max_count);
+		if (dir == OCF_WRITE && !io_hndl)
+			m_req->data = ctx_data_zalloc(cache->owner, data_pages);
+		else
+			m_req->data = ctx_data_alloc(cache->owner, data_pages);
 		if (!m_req->data)
 			goto err;
 	}
@@ -117,7 +117,7 @@ int metadata_io_read_i_atomic(ocf_cache_t cache, ocf_queue_t queue,
  * @param context - Read context
  * @param page - Start page of SSD (cache device) where data will be written
  * @param count - Counts of page to be processed
- * @param fill_hndl - Fill callback
+ * @param fill_hndl - Fill callback, NULL to write zeroes
  * @param compl_hndl - All IOs completed callback
  *
  * @return 0 - No errors, otherwise error occurred
@@ -243,14 +243,6 @@ static int _raw_ram_update(ocf_cache_t cache,
 
 }
 
-static int raw_ram_zero_do_asynch_fill(ocf_cache_t cache,
-		ctx_data_t *data, uint32_t page, void *context)
-{
-	ctx_data_zero(cache->owner, data, PAGE_SIZE);
-
-	return 0;
-}
-
 struct ocf_raw_ram_zero_ctx
 {
 	ocf_metadata_end_t cmpl;
@@ -283,8 +275,7 @@ static void raw_ram_zero(ocf_cache_t cache, struct ocf_metadata_raw *raw,
 	metadata_io_write_i_asynch(cache, cache->mngt_queue, ctx,
 				raw->ssd_pages_offset,
 				_raw_ram_segment_size_on_ssd_total(raw),
-				0, raw_ram_zero_do_asynch_fill,
-				raw_ram_zero_end, NULL);
+				0, NULL, raw_ram_zero_end, NULL);
 }
 
 struct _raw_ram_load_all_context {
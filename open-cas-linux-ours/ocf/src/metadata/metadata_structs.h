@@ -36,20 +36,37 @@ enum ocf_metadata_shutdown_status {
 typedef void (*ocf_metadata_query_cores_end_t)(void *priv, int error,
 		unsigned int num_cores);
 
-#define OCF_METADATA_GLOBAL_LOCK_IDX_BITS 2
+#define OCF_METADATA_GLOBAL_LOCK_IDX_BITS 4
 #define OCF_NUM_GLOBAL_META_LOCKS (1 << (OCF_METADATA_GLOBAL_LOCK_IDX_BITS))
 
+/* Per execution context reader count of global metadata lock */
 struct ocf_metadata_global_lock {
+	env_atomic readers;
+} __attribute__((aligned(64)));
+
+/* Exclusive side of global metadata lock */
+struct ocf_metadata_global_excl {
+	env_atomic writer;
+		/*!< Set while exclusive access is pending or held */
 	env_rwsem sem;
+		/*!< Serializes writers and parks readers while writer is active */
+	env_atomic waiting;
+		/*!< Set while writer sleeps waiting for readers to drain */
+	env_completion drained;
+		/*!< Completed by the reader which drains reader counters */
 } __attribute__((aligned(64)));
 
 struct ocf_metadata_lock
 {
 	struct ocf_metadata_global_lock global[OCF_NUM_GLOBAL_META_LOCKS];
 			/*!< global metadata lock (GML) */
+	struct ocf_metadata_global_excl excl;
+			/*!< GML exclusive access */
 	env_rwlock lru[OCF_NUM_LRU_LISTS]; /*!< Fast locks for lru list */
 	env_spinlock partition[OCF_USER_IO_CLASS_MAX]; /* partition lock */
 	env_rwsem *hash; /*!< Hash bucket locks */
+	env_atomic *hash_seq; /*!< Hash bucket sequence counters */
+	env_atomic excl_seq; /*!< Exclusive access sequence counter */
 	env_rwsem *collision_pages; /*!< Collision table page locks */
 	ocf_cache_t cache;  /*!< Parent cache object */
 	uint32_t num_hash_entries;  /*!< Hash bucket count */
@@ -14,6 +14,7 @@
 #include "../metadata/metadata_io.h"
 #include "../metadata/metadata_partition_structs.h"
 #include "../engine/cache_engine.h"
+#include "../engine/engine_common.h"
 #include "../utils/utils_user_part.h"
 #include "../utils/utils_cache_line.h"
 #include "../utils/utils_io.h"
@@ -142,6 +143,8 @@ struct ocf_cache_attach_context {
 
 		bool concurrency_inited : 1;
 
+		bool lru_runtime_inited : 1;
+
 		bool pio_mpool : 1;
 
 		bool pio_concurrency : 1;
@@ -571,7 +574,6 @@ static void ocf_mngt_rebuild_metadata_finish(ocf_parallelize_t parallelize,
 	struct ocf_mngt_rebuild_metadata_context *context = priv;
 	ocf_cache_t cache = context->cache;
 	ocf_part_id_t part_id = PARTITION_DEFAULT;
-	struct ocf_part_runtime *part;
 	ocf_core_t core;
 	ocf_core_id_t core_id;
 	uint32_t lines_total = 0;
@@ -593,10 +595,10 @@ static void ocf_mngt_rebuild_metadata_finish(ocf_parallelize_t parallelize,
 		lines_total += lines;
 	}
 
-	part = cache->user_parts[part_id].part.runtime;
-	env_atomic_set(&part->curr_size, lines_total);
+	ocf_lru_occupancy_set(cache, &cache->user_parts[part_id].part,
+			lines_total);
 
-	env_atomic_set(&cache->free.runtime->curr_size,
+	ocf_lru_occupancy_set(cache, &cache->free,
 			env_atomic_read(&context->free_lines));
 
 	context->cmpl(context->priv, error);
@@ -758,6 +760,12 @@ static int _ocf_mngt_init_new_cache(struct ocf_cache_mngt_init_params *params)
 		goto lock_err;
 	}
 
+	ocf_rcu_init(&cache->rcu, cache, &cache->refcnt.metadata);
+
+	result = ocf_engine_inline_resume_init(cache);
+	if (result)
+		goto rcu_err;
+
 	ENV_BUG_ON(!ocf_refcnt_inc(&cache->refcnt.cache));
 
 	/* start with freezed metadata ref counter to indicate detached device*/
@@ -773,6 +781,9 @@ static int _ocf_mngt_init_new_cache(struct ocf_cache_mngt_init_params *params)
 
 	return 0;
 
+rcu_err:
+	ocf_rcu_deinit(&cache->rcu);
+	env_mutex_destroy(&cache->flush_mutex);
 lock_err:
 	ocf_mngt_cache_lock_deinit(cache);
 alloc_err:
@@ -853,11 +864,14 @@ static int _ocf_mngt_init_prepare_cache(struct ocf_cache_mngt_init_params *param
 
 	cache->backfill.max_queue_size = cfg->backfill.max_queue_size;
 	cache->backfill.queue_unblock_size = cfg->backfill.queue_unblock_size;
+	cache->backfill.mode = cfg->backfill.mode;
 
 	param->flags.cache_locked = true;
 
 	cache->pt_unaligned_io = cfg->pt_unaligned_io;
 	cache->use_submit_io_fast = cfg->use_submit_io_fast;
+	cache->inline_resume = cfg->inline_resume;
+	cache->memory_budget = cfg->memory_budget;
 
 	cache->metadata.is_volatile = cfg->metadata_volatile;
 
@@ -1175,6 +1189,12 @@ static void _ocf_mngt_attach_prepare_metadata(ocf_pipeline_t pipeline,
 
 	context->flags.concurrency_inited = 1;
 
+	ret = ocf_lru_runtime_init(cache);
+	if (ret)
+		OCF_PL_FINISH_RET(pipeline, ret);
+
+	context->flags.lru_runtime_inited = 1;
+
 	ocf_pipeline_next(pipeline);
 }
 
@@ -1310,6 +1330,8 @@ static void _ocf_mngt_init_handle_error(ocf_ctx_t ctx,
 	env_rmutex_lock(&ctx->lock);
 
 	list_del(&cache->list);
+	ocf_engine_inline_resume_deinit(cache);
+	ocf_rcu_deinit(&cache->rcu);
 	env_vfree(cache);
 
 	env_rmutex_unlock(&ctx->lock);
@@ -1563,6 +1585,31 @@ static void _ocf_mngt_init_promotion(ocf_pipeline_t pipeline,
 	ocf_pipeline_next(pipeline);
 }
 
+static void _ocf_mngt_attach_check_memory_budget(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_cache_attach_context *context = priv;
+	ocf_cache_t cache = context->cache;
+	struct ocf_cache_memory_footprint footprint;
+
+	if (!cache->memory_budget)
+		OCF_PL_NEXT_RET(pipeline);
+
+	ocf_cache_get_memory_footprint(cache, &footprint);
+
+	ocf_cache_log(cache, log_info, "Memory footprint: %" ENV_PRIu64
+			" B, budget: %" ENV_PRIu64 " B\n",
+			footprint.total, footprint.budget);
+
+	if (footprint.total > footprint.budget) {
+		ocf_cache_log(cache, log_err, "Cache metadata does not fit "
+				"into memory budget\n");
+		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_NO_FREE_RAM);
+	}
+
+	ocf_pipeline_next(pipeline);
+}
+
 static void _ocf_mngt_zero_superblock_complete(void *priv, int error)
 {
 	struct ocf_cache_attach_context *context = priv;
@@ -1735,6 +1782,9 @@ static void _ocf_mngt_attach_handle_error(
 	if (context->flags.attached_metadata_inited)
 		ocf_metadata_deinit_variable_size(cache);
 
+	if (context->flags.lru_runtime_inited)
+		ocf_lru_runtime_deinit(cache);
+
 	if (context->flags.concurrency_inited)
 		ocf_concurrency_deinit(cache);
 
@@ -1792,6 +1842,7 @@ struct ocf_pipeline_properties _ocf_mngt_cache_attach_pipeline_properties = {
 		OCF_PL_STEP(_ocf_mngt_test_volume),
 		OCF_PL_STEP(_ocf_mngt_init_cleaner),
 		OCF_PL_STEP(_ocf_mngt_init_promotion),
+		OCF_PL_STEP(_ocf_mngt_attach_check_memory_budget),
 		OCF_PL_STEP(_ocf_mngt_attach_init_metadata),
 		OCF_PL_STEP(_ocf_mngt_attach_populate_free),
 		OCF_PL_STEP(_ocf_mngt_attach_init_services),
@@ -1819,6 +1870,7 @@ struct ocf_pipeline_properties _ocf_mngt_cache_load_pipeline_properties = {
 		OCF_PL_STEP(_ocf_mngt_load_superblock),
 		OCF_PL_STEP(_ocf_mngt_init_cleaner),
 		OCF_PL_STEP(_ocf_mngt_init_promotion),
+		OCF_PL_STEP(_ocf_mngt_attach_check_memory_budget),
 		OCF_PL_STEP(_ocf_mngt_load_add_cores),
 		OCF_PL_STEP(_ocf_mngt_load_metadata),
 		OCF_PL_STEP(_ocf_mngt_load_rebuild_metadata),
@@ -1988,6 +2040,7 @@ static void ocf_mngt_cache_deinit_metadata(ocf_pipeline_t pipeline,
 
 
 	ocf_metadata_deinit_variable_size(cache);
+	ocf_lru_runtime_deinit(cache);
 	ocf_concurrency_deinit(cache);
 
 	/* TODO: this should be removed from detach after 'attached' stats
@@ -2788,6 +2841,11 @@ static int _ocf_mngt_cache_validate_cfg(struct ocf_mngt_cache_config *cfg)
 	if (cfg->backfill.queue_unblock_size > cfg->backfill.max_queue_size )
 		return -OCF_ERR_INVAL;
 
+	if (cfg->backfill.mode >= ocf_backfill_mode_max ||
+			cfg->backfill.mode < ocf_backfill_mode_copy) {
+		return -OCF_ERR_INVAL;
+	}
+
 	return 0;
 }
 
@@ -3355,12 +3413,9 @@ int ocf_mngt_cache_promotion_set_policy(ocf_cache_t cache, ocf_promotion_t type)
 	if (ocf_cache_is_standby(cache))
 		return -OCF_ERR_CACHE_STANDBY;
 
-	ocf_metadata_start_exclusive_access(&cache->metadata.lock);
-
+	/* New policy is published under grace period, I/O keeps running */
 	result = ocf_promotion_set_policy(cache->promotion_policy, type);
 
-	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
-
 	return result;
 }
 
@@ -3400,18 +3455,12 @@ int ocf_mngt_cache_promotion_get_param(ocf_cache_t cache, ocf_promotion_t type,
 int ocf_mngt_cache_promotion_set_param(ocf_cache_t cache, ocf_promotion_t type,
 		uint8_t param_id, uint32_t param_value)
 {
-	int result;
-
 	if (ocf_cache_is_standby(cache))
 		return -OCF_ERR_CACHE_STANDBY;
 
-	ocf_metadata_start_exclusive_access(&cache->metadata.lock);
-
-	result = ocf_promotion_set_param(cache, type, param_id, param_value);
-
-	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
-
-	return result;
+	/* Parameters are single word values read racily by I/O path, no need
+	 * to stop it */
+	return ocf_promotion_set_param(cache, type, param_id, param_value);
 }
 
 int ocf_mngt_cache_reset_fallback_pt_error_counter(ocf_cache_t cache)
@@ -146,6 +146,8 @@ void ocf_mngt_cache_put(ocf_cache_t cache)
 	if (ocf_refcnt_dec(&cache->refcnt.cache) == 0) {
 		ctx = cache->owner;
 		ocf_metadata_deinit(cache);
+		ocf_engine_inline_resume_deinit(cache);
+		ocf_rcu_deinit(&cache->rcu);
 		env_vfree(cache);
 		ocf_ctx_put(ctx);
 	}
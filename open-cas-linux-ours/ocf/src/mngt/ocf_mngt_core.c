@@ -425,6 +425,12 @@ static void ocf_mngt_cache_add_core_insert(ocf_pipeline_t pipeline,
 		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_CORE_NOT_AVAIL);
 	}
 
+	if (length / ocf_cache_line_size_min > OCF_METADATA_CORE_LINE_MAX) {
+		ocf_cache_log(cache, log_err, "Core %s is too big for "
+				"metadata format\n", cfg->name);
+		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_INVAL);
+	}
+
 	core->conf_meta->length = length;
 	core->conf_meta->type = cfg->volume_type;
 
@@ -15,6 +15,8 @@
 #include "ocf_cache_priv.h"
 #include "ocf_queue_priv.h"
 #include "utils/utils_stats.h"
+#include "promotion/promotion.h"
+#include "ocf_lru.h"
 
 ocf_volume_t ocf_cache_get_volume(ocf_cache_t cache)
 {
@@ -216,6 +218,68 @@ int ocf_cache_get_info(ocf_cache_t cache, struct ocf_cache_info *info)
 	return 0;
 }
 
+int ocf_cache_get_memory_footprint(ocf_cache_t cache,
+		struct ocf_cache_memory_footprint *footprint)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (!footprint)
+		return -OCF_ERR_INVAL;
+
+	ENV_BUG_ON(env_memset(footprint, sizeof(*footprint), 0));
+
+	footprint->budget = cache->memory_budget;
+
+	if (!ocf_cache_is_device_attached(cache))
+		return 0;
+
+	if (ocf_cache_is_standby(cache) &&
+			ocf_refcnt_frozen(&cache->refcnt.metadata)) {
+		return 0;
+	}
+
+	ocf_metadata_get_memory_footprint(cache, footprint);
+	footprint->lru += ocf_lru_runtime_size_of(cache);
+
+	footprint->cleaning_policy = ocf_cleaning_size_of(cache);
+	if (cache->promotion_policy) {
+		footprint->promotion_policy =
+				ocf_promotion_size_of(cache->promotion_policy);
+	}
+
+	footprint->total = footprint->superblock + footprint->partitions +
+			footprint->cores + footprint->cleaning +
+			footprint->lru + footprint->collision +
+			footprint->list_info + footprint->hash +
+			footprint->cache_line_locks +
+			footprint->metadata_locks +
+			footprint->cleaning_policy +
+			footprint->promotion_policy;
+
+	return 0;
+}
+
+int ocf_cache_get_lock_stats(ocf_cache_t cache,
+		struct ocf_cache_lock_stats *stats)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (!stats)
+		return -OCF_ERR_INVAL;
+
+	ENV_BUG_ON(env_memset(stats, sizeof(*stats), 0));
+
+	if (!ocf_cache_is_device_attached(cache))
+		return 0;
+
+	if (!ocf_cache_line_concurrency(cache))
+		return 0;
+
+	ocf_alock_get_stats(ocf_cache_line_concurrency(cache), stats);
+
+	return 0;
+}
+
 const struct ocf_volume_uuid *ocf_cache_get_uuid(ocf_cache_t cache)
 {
 	if (!ocf_cache_is_device_attached(cache))
@@ -301,7 +365,8 @@ static void ocf_cache_volume_io_complete_generic(struct ocf_io *vol_io,
 
 	ocf_io_put(vol_io);
 	ocf_io_end(io, error);
-	ocf_refcnt_dec(&cache->refcnt.metadata);
+	if (!ocf_refcnt_dec(&cache->refcnt.metadata))
+		ocf_rcu_readers_drained(&cache->rcu);
 }
 
 static void ocf_cache_io_complete(struct ocf_io *io, int error)
@@ -318,7 +383,8 @@ static void ocf_cache_io_complete(struct ocf_io *io, int error)
 	if (env_atomic_dec_return(&priv->remaining))
 		return;
 
-	ocf_refcnt_dec(&cache->refcnt.metadata);
+	if (!ocf_refcnt_dec(&cache->refcnt.metadata))
+		ocf_rcu_readers_drained(&cache->rcu);
 	ocf_io_end(io, env_atomic_read(&priv->error));
 }
 
@@ -16,6 +16,7 @@
 #include "utils/utils_pipeline.h"
 #include "utils/utils_refcnt.h"
 #include "utils/utils_async_lock.h"
+#include "utils/utils_rcu.h"
 #include "ocf_stats_priv.h"
 #include "cleaning/cleaning.h"
 #include "ocf_logger_priv.h"
@@ -48,6 +49,12 @@ struct ocf_cache_device {
 		struct ocf_alock *cache_line;
 	} concurrency;
 
+	unsigned long *lru_referenced;
+		/*!< Per cache line LRU reference hint bitmap (runtime only) */
+
+	struct ocf_part_occupancy_shard *part_occupancy;
+		/*!< Per execution context partition occupancy deltas */
+
 	struct ocf_superblock_runtime *runtime_meta;
 };
 
@@ -85,6 +92,9 @@ struct ocf_cache {
 		struct ocf_refcnt metadata __attribute__((aligned(64)));
 	} refcnt;
 
+	/* grace periods for configuration published without freezing I/O */
+	struct ocf_rcu rcu;
+
 	struct {
 		env_allocator *allocator;
 		struct ocf_alock *concurrency;
@@ -110,6 +120,7 @@ struct ocf_cache {
 	struct {
 		uint32_t max_queue_size;
 		uint32_t queue_unblock_size;
+		ocf_backfill_mode_t mode;
 	} backfill;
 
 	void *priv;
@@ -126,6 +137,13 @@ struct ocf_cache {
 
 	bool use_submit_io_fast;
 
+	bool inline_resume;
+
+	/* Per execution context count of requests resumed inline */
+	struct ocf_engine_inline_resume_depth *inline_resume_depth;
+
+	uint64_t memory_budget;
+
 	struct {
 		struct ocf_async_lock lock;
 	} __attribute__((aligned(64)));
@@ -404,6 +404,10 @@ static void ocf_core_volume_submit_discard(struct ocf_io *io)
 		return;
 	}
 
+	req->discard.sector = BYTES_TO_SECTORS(req->byte_position);
+	req->discard.nr_sects = BYTES_TO_SECTORS(req->byte_length);
+	req->discard.handled = 0;
+
 	ret = ocf_req_alloc_map_discard(req);
 	if (ret) {
 		ocf_io_end(io, -OCF_ERR_NO_MEM);
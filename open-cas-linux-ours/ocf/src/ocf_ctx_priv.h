@@ -38,6 +38,7 @@ struct ocf_ctx {
 	const struct ocf_ctx_ops *ops;
 	struct {
 		struct env_mpool *req;
+		struct env_mpool *req_map;
 		struct env_mpool *mio;
 	} resources;
 	struct list_head caches;
@@ -86,6 +87,23 @@ static inline void ctx_data_free(ocf_ctx_t ctx, ctx_data_t *data)
 	ctx->ops->data.free(data);
 }
 
+static inline void *ctx_data_zalloc(ocf_ctx_t ctx, uint32_t pages)
+{
+	ctx_data_t *data;
+
+	if (ctx->ops->data.zalloc)
+		return ctx->ops->data.zalloc(pages);
+
+	data = ctx->ops->data.alloc(pages);
+	if (!data)
+		return NULL;
+
+	ctx->ops->data.zero(data, pages * PAGE_SIZE);
+	ctx->ops->data.seek(data, ctx_data_seek_begin, 0);
+
+	return data;
+}
+
 static inline int ctx_data_mlock(ocf_ctx_t ctx, ctx_data_t *data)
 {
 	return ctx->ops->data.mlock(data);
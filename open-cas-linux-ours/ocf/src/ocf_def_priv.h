@@ -36,8 +36,9 @@
 		__x < __y ? __x : __y;		\
 	})
 
-#define METADATA_VERSION() ((OCF_VERSION_MAIN << 16) + \
-		(OCF_VERSION_MAJOR << 8) + OCF_VERSION_MINOR)
+#define METADATA_VERSION() ((OCF_CONFIG_COMPACT_METADATA << 24) + \
+		(OCF_VERSION_MAIN << 16) + (OCF_VERSION_MAJOR << 8) + \
+		OCF_VERSION_MINOR)
 
 /* call conditional reschedule every 'iterations' calls */
 #define OCF_COND_RESCHED(cnt, iterations) \
@@ -8,6 +8,7 @@
 #include "metadata/metadata.h"
 #include "engine/cache_engine.h"
 #include "utils/utils_user_part.h"
+#include "ocf_lru.h"
 
 int ocf_cache_io_class_get_info(ocf_cache_t cache, uint32_t io_class,
 		struct ocf_io_class_info *info)
@@ -41,7 +42,7 @@ int ocf_cache_io_class_get_info(ocf_cache_t cache, uint32_t io_class,
 
 	info->priority = cache->user_parts[part_id].config->priority;
 	info->curr_size = ocf_cache_is_device_attached(cache) ?
-			env_atomic_read(&part->runtime->curr_size) : 0;
+			ocf_lru_part_occupancy_exact(cache, part) : 0;
 	info->min_size = cache->user_parts[part_id].config->min_size;
 	info->max_size = cache->user_parts[part_id].config->max_size;
 
@@ -8,6 +8,7 @@
 #include "utils/utils_cleaner.h"
 #include "utils/utils_cache_line.h"
 #include "utils/utils_generator.h"
+#include "utils/utils_user_part.h"
 #include "utils/utils_parallelize.h"
 #include "concurrency/ocf_concurrency.h"
 #include "mngt/ocf_mngt_common.h"
@@ -18,6 +19,146 @@
 
 static const ocf_cache_line_t end_marker = (ocf_cache_line_t)-1;
 
+/* Max number of referenced cachelines given second chance during a single
+ * eviction list scan, bounds LRU list lock hold time */
+#define OCF_LRU_SECOND_CHANCE_MAX 32
+
+/* Max absolute value of per execution context occupancy delta before it is
+ * folded into partition curr_size. Occupancy read from curr_size is off
+ * by less than OCF_PART_OCCUPANCY_BATCH * execution context count. */
+#define OCF_PART_OCCUPANCY_BATCH 32
+
+struct ocf_part_occupancy_shard {
+	env_atomic delta[PARTITION_FREELIST + 1];
+} __attribute__((aligned(64)));
+
+/* Size of second chance reference bitmap, one bit per cacheline */
+static inline size_t ocf_lru_referenced_size(ocf_cache_t cache)
+{
+	return OCF_DIV_ROUND_UP(ocf_metadata_collision_table_entries(cache),
+			sizeof(unsigned long) * 8) * sizeof(unsigned long);
+}
+
+int ocf_lru_runtime_init(ocf_cache_t cache)
+{
+	cache->device->lru_referenced = env_vzalloc(
+			ocf_lru_referenced_size(cache));
+	if (!cache->device->lru_referenced)
+		return -OCF_ERR_NO_MEM;
+
+	cache->device->part_occupancy = env_vzalloc(
+			sizeof(struct ocf_part_occupancy_shard) *
+			env_get_execution_context_count());
+	if (!cache->device->part_occupancy) {
+		env_vfree(cache->device->lru_referenced);
+		cache->device->lru_referenced = NULL;
+		return -OCF_ERR_NO_MEM;
+	}
+
+	return 0;
+}
+
+void ocf_lru_runtime_deinit(ocf_cache_t cache)
+{
+	env_vfree(cache->device->part_occupancy);
+	cache->device->part_occupancy = NULL;
+	env_vfree(cache->device->lru_referenced);
+	cache->device->lru_referenced = NULL;
+}
+
+size_t ocf_lru_runtime_size_of(ocf_cache_t cache)
+{
+	if (!cache->device->lru_referenced)
+		return 0;
+
+	return ocf_lru_referenced_size(cache) +
+		sizeof(struct ocf_part_occupancy_shard) *
+		env_get_execution_context_count();
+}
+
+static inline void ocf_lru_occupancy_fold(struct ocf_part *part,
+		env_atomic *delta, int val)
+{
+	env_atomic_sub(val, delta);
+	env_atomic_add(val, &part->runtime->curr_size);
+}
+
+static inline void ocf_lru_occupancy_add(struct ocf_part_occupancy_shard *shard,
+		struct ocf_part *part, int val)
+{
+	env_atomic *delta = &shard->delta[part->id];
+
+	val = env_atomic_add_return(val, delta);
+	if (val >= OCF_PART_OCCUPANCY_BATCH || val <= -OCF_PART_OCCUPANCY_BATCH)
+		ocf_lru_occupancy_fold(part, delta, val);
+}
+
+static void ocf_lru_occupancy_move(ocf_cache_t cache,
+		struct ocf_part *src_part, struct ocf_part *dst_part)
+{
+	struct ocf_part_occupancy_shard *shard;
+	unsigned ctx;
+
+	ctx = env_get_execution_context();
+	shard = &cache->device->part_occupancy[ctx];
+
+	ocf_lru_occupancy_add(shard, src_part, -1);
+	ocf_lru_occupancy_add(shard, dst_part, 1);
+
+	env_put_execution_context(ctx);
+}
+
+static void ocf_lru_occupancy_sync_part(ocf_cache_t cache,
+		struct ocf_part *part)
+{
+	struct ocf_part_occupancy_shard *shards = cache->device->part_occupancy;
+	unsigned i, count = env_get_execution_context_count();
+	env_atomic *delta;
+	int val;
+
+	if (!shards)
+		return;
+
+	for (i = 0; i < count; i++) {
+		delta = &shards[i].delta[part->id];
+		val = env_atomic_read(delta);
+		if (val)
+			ocf_lru_occupancy_fold(part, delta, val);
+	}
+}
+
+/* Reset partition occupancy to given value, discarding pending deltas */
+void ocf_lru_occupancy_set(ocf_cache_t cache, struct ocf_part *part,
+		uint32_t value)
+{
+	struct ocf_part_occupancy_shard *shards = cache->device->part_occupancy;
+	unsigned i, count = env_get_execution_context_count();
+
+	if (shards) {
+		for (i = 0; i < count; i++)
+			env_atomic_set(&shards[i].delta[part->id], 0);
+	}
+
+	env_atomic_set(&part->runtime->curr_size, value);
+}
+
+void ocf_lru_occupancy_sync(ocf_cache_t cache)
+{
+	ocf_part_id_t part_id;
+
+	for (part_id = 0; part_id < OCF_USER_IO_CLASS_MAX; part_id++)
+		ocf_lru_occupancy_sync_part(cache, &cache->user_parts[part_id].part);
+
+	ocf_lru_occupancy_sync_part(cache, &cache->free);
+}
+
+uint32_t ocf_lru_part_occupancy_exact(ocf_cache_t cache, struct ocf_part *part)
+{
+	ocf_lru_occupancy_sync_part(cache, part);
+
+	return ocf_part_get_occupancy(part);
+}
+
 /* update list last_hot index. returns pivot element (the one for which hot
  * status effectively changes during balancing). */
 static inline ocf_cache_line_t balance_update_last_hot(ocf_cache_t cache,
@@ -221,6 +362,9 @@ void ocf_lru_init_cline(ocf_cache_t cache, ocf_cache_line_t cline)
 	node->hot = false;
 	node->prev = end_marker;
 	node->next = end_marker;
+
+	if (cache->device->lru_referenced)
+		env_bit_clear(cline, cache->device->lru_referenced);
 }
 
 struct ocf_lru_list *ocf_lru_get_list(struct ocf_part *part,
@@ -276,8 +420,7 @@ static void ocf_lru_repart_locked(ocf_cache_t cache, ocf_cache_line_t cline,
 
 	ocf_lru_move(cache, cline, src_list, dst_list);
 	ocf_metadata_set_partition_id(cache, cline, dst_part->id);
-	env_atomic_dec(&src_part->runtime->curr_size);
-	env_atomic_inc(&dst_part->runtime->curr_size);
+	ocf_lru_occupancy_move(cache, src_part, dst_part);
 }
 
 void ocf_lru_repart(ocf_cache_t cache, ocf_cache_line_t cline,
@@ -454,6 +597,9 @@ static inline ocf_cache_line_t lru_iter_eviction_next(struct ocf_lru_iter *iter,
 	ocf_cache_t cache = iter->cache;
 	struct ocf_part *part = iter->part;
 	struct ocf_lru_list *list;
+	unsigned long *referenced = cache->device->lru_referenced;
+	ocf_cache_line_t prev;
+	unsigned second_chances;
 
 	do {
 		curr_lru = _lru_next_lru(iter);
@@ -463,12 +609,32 @@ static inline ocf_cache_line_t lru_iter_eviction_next(struct ocf_lru_iter *iter,
 		list = ocf_lru_get_list(part, curr_lru, iter->clean);
 
 		cline = list->tail;
-		while (cline != end_marker && !_lru_iter_evition_lock(iter,
-				cline, core_id, core_line)) {
-			cline = ocf_metadata_get_lru(iter->cache, cline)->prev;
+		second_chances = 0;
+		while (cline != end_marker) {
+			prev = ocf_metadata_get_lru(iter->cache, cline)->prev;
+
+			/* Cacheline hit since it fell out of the hot part of
+			 * the list - move it back to the head instead of
+			 * evicting */
+			if (env_bit_test(cline, referenced) && second_chances <
+					OCF_LRU_SECOND_CHANCE_MAX) {
+				env_bit_clear(cline, referenced);
+				second_chances++;
+				ocf_lru_set_hot(cache, list, cline);
+				cline = prev;
+				continue;
+			}
+
+			if (_lru_iter_evition_lock(iter, cline, core_id,
+					core_line)) {
+				break;
+			}
+
+			cline = prev;
 		}
 
 		if (cline != end_marker) {
+			env_bit_clear(cline, referenced);
 			if (dst_part != part) {
 				ocf_lru_repart_locked(cache, cline, part,
 						dst_part);
@@ -770,40 +936,25 @@ uint32_t ocf_lru_req_clines(struct ocf_request *req,
 	return i;
 }
 
-/* the caller must hold the metadata lock */
+/*
+ * Second chance (CLOCK) promotion - hit only marks the cacheline as
+ * referenced and eviction moves referenced cachelines back to the list head
+ * under the list lock it holds anyway. Neither read is done under LRU lock,
+ * both the hot flag and the reference bit are just hints: a stale value
+ * costs at most one cacheline being evicted or kept slightly out of order.
+ * Reference bits share words, so they are only changed with atomic bit ops.
+ */
 void ocf_lru_hot_cline(ocf_cache_t cache, ocf_cache_line_t cline)
 {
-	const uint32_t lru_list = (cline % OCF_NUM_LRU_LISTS);
 	struct ocf_lru_meta *node;
-	struct ocf_lru_list *list;
-	ocf_part_id_t part_id;
-	struct ocf_part *part;
-	bool hot;
-	bool clean;
+	unsigned long *referenced = cache->device->lru_referenced;
 
 	node = ocf_metadata_get_lru(cache, cline);
 
-	OCF_METADATA_LRU_RD_LOCK(cline);
-	hot = node->hot;
-	OCF_METADATA_LRU_RD_UNLOCK(cline);
-
-	if (hot)
+	if (node->hot || env_bit_test(cline, referenced))
 		return;
 
-	part_id = ocf_metadata_get_partition_id(cache, cline);
-	part = &cache->user_parts[part_id].part;
-	clean = !metadata_test_dirty(cache, cline);
-	list = ocf_lru_get_list(part, lru_list, clean);
-
-	OCF_METADATA_LRU_WR_LOCK(cline);
-
-	/* cacheline must be on the list when set_hot gets called */
-	ENV_BUG_ON(node->next == end_marker && list->tail != cline);
-	ENV_BUG_ON(node->prev == end_marker && list->head != cline);
-
-	ocf_lru_set_hot(cache, list, cline);
-
-	OCF_METADATA_LRU_WR_UNLOCK(cline);
+	env_bit_set(cline, referenced);
 }
 
 static inline void _lru_init(struct ocf_lru_list *list, bool track_hot)
@@ -834,7 +985,7 @@ void ocf_lru_init(ocf_cache_t cache, struct ocf_part *part)
 		}
 	}
 
-	env_atomic_set(&part->runtime->curr_size, 0);
+	ocf_lru_occupancy_set(cache, part, 0);
 }
 
 void ocf_lru_clean_cline(ocf_cache_t cache, struct ocf_part *part,
@@ -923,7 +1074,7 @@ static void ocf_lru_populate_finish(ocf_parallelize_t parallelize,
 {
 	struct ocf_lru_populate_context *context = priv;
 
-	env_atomic_set(&context->cache->free.runtime->curr_size,
+	ocf_lru_occupancy_set(context->cache, &context->cache->free,
 		env_atomic_read(&context->curr_size));
 
 	context->cmpl(context->priv, error);
@@ -1055,7 +1206,7 @@ int ocf_metadata_actor(struct ocf_cache *cache,
 
 uint32_t ocf_lru_num_free(ocf_cache_t cache)
 {
-	return env_atomic_read(&cache->free.runtime->curr_size);
+	return ocf_part_get_occupancy(&cache->free);
 }
 
 void ocf_lru_add_free(ocf_cache_t cache, ocf_cache_line_t cline)
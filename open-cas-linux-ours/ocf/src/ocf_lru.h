@@ -14,6 +14,13 @@ struct ocf_part_runtime;
 struct ocf_part_cleaning_ctx;
 struct ocf_request;
 
+int ocf_lru_runtime_init(ocf_cache_t cache);
+void ocf_lru_runtime_deinit(ocf_cache_t cache);
+size_t ocf_lru_runtime_size_of(ocf_cache_t cache);
+void ocf_lru_occupancy_set(ocf_cache_t cache, struct ocf_part *part,
+		uint32_t value);
+void ocf_lru_occupancy_sync(ocf_cache_t cache);
+uint32_t ocf_lru_part_occupancy_exact(ocf_cache_t cache, struct ocf_part *part);
 void ocf_lru_init_cline(ocf_cache_t cache, ocf_cache_line_t cline);
 void ocf_lru_rm_cline(struct ocf_cache *cache, ocf_cache_line_t cline);
 bool ocf_lru_can_evict(struct ocf_cache *cache);
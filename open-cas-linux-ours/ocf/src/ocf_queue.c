@@ -12,12 +12,21 @@
 #include "mngt/ocf_mngt_common.h"
 #include "engine/cache_engine.h"
 #include "ocf_def_priv.h"
+#include "utils/utils_alock.h"
+
+static const uint32_t ocf_queue_lane_default_weight[ocf_queue_lane_max] = {
+	[ocf_queue_lane_user_read] = 8,
+	[ocf_queue_lane_user_write] = 4,
+	[ocf_queue_lane_background] = 2,
+	[ocf_queue_lane_mngt] = 1,
+};
 
 int ocf_queue_create(ocf_cache_t cache, ocf_queue_t *queue,
 		const struct ocf_queue_ops *ops)
 {
 	ocf_queue_t tmp_queue;
 	int result;
+	int i;
 
 	OCF_CHECK_NULL(cache);
 
@@ -32,6 +41,9 @@ int ocf_queue_create(ocf_cache_t cache, ocf_queue_t *queue,
 	}
 
 	env_atomic_set(&tmp_queue->io_no, 0);
+	env_atomic64_set(&tmp_queue->map_inline, 0);
+	env_atomic64_set(&tmp_queue->map_pool, 0);
+	env_atomic64_set(&tmp_queue->map_fallback, 0);
 	result = env_spinlock_init(&tmp_queue->io_list_lock);
 	if (result) {
 		ocf_mngt_cache_put(cache);
@@ -39,13 +51,36 @@ int ocf_queue_create(ocf_cache_t cache, ocf_queue_t *queue,
 		return result;
 	}
 
-	INIT_LIST_HEAD(&tmp_queue->io_list);
+	result = ocf_req_cache_init(tmp_queue);
+	if (result) {
+		env_spinlock_destroy(&tmp_queue->io_list_lock);
+		ocf_mngt_cache_put(cache);
+		env_free(tmp_queue);
+		return result;
+	}
+
+	result = ocf_alock_waiter_pool_init(tmp_queue);
+	if (result) {
+		ocf_req_cache_deinit(tmp_queue);
+		env_spinlock_destroy(&tmp_queue->io_list_lock);
+		ocf_mngt_cache_put(cache);
+		env_free(tmp_queue);
+		return result;
+	}
+
+	for (i = 0; i < ocf_queue_lane_max; i++) {
+		INIT_LIST_HEAD(&tmp_queue->lanes[i].io_list);
+		tmp_queue->lanes[i].weight = ocf_queue_lane_default_weight[i];
+		tmp_queue->lanes[i].credit = tmp_queue->lanes[i].weight;
+	}
 	env_atomic_set(&tmp_queue->ref_count, 1);
 	tmp_queue->cache = cache;
 	tmp_queue->ops = ops;
 
 	result = ocf_queue_seq_cutoff_init(tmp_queue);
 	if (result) {
+		ocf_alock_waiter_pool_deinit(tmp_queue);
+		ocf_req_cache_deinit(tmp_queue);
 		ocf_mngt_cache_put(cache);
 		env_free(tmp_queue);
 		return result;
@@ -73,6 +108,8 @@ void ocf_queue_put(ocf_queue_t queue)
 		list_del(&queue->list);
 		queue->ops->stop(queue);
 		ocf_queue_seq_cutoff_deinit(queue);
+		ocf_alock_waiter_pool_deinit(queue);
+		ocf_req_cache_deinit(queue);
 		ocf_mngt_cache_put(queue->cache);
 		env_spinlock_destroy(&queue->io_list_lock);
 		env_free(queue);
@@ -139,6 +176,37 @@ uint32_t ocf_queue_pending_io(ocf_queue_t q)
 	return env_atomic_read(&q->io_no);
 }
 
+int ocf_queue_set_lane_weight(ocf_queue_t q, ocf_queue_lane_t lane,
+		uint32_t weight)
+{
+	unsigned long lock_flags = 0;
+
+	OCF_CHECK_NULL(q);
+
+	if (lane < ocf_queue_lane_user_read || lane >= ocf_queue_lane_max)
+		return -OCF_ERR_INVAL;
+
+	env_spinlock_lock_irqsave(&q->io_list_lock, lock_flags);
+	q->lanes[lane].weight = weight;
+	q->lanes[lane].credit = weight;
+	env_spinlock_unlock_irqrestore(&q->io_list_lock, lock_flags);
+
+	return 0;
+}
+
+void ocf_queue_get_req_alloc_stats(ocf_queue_t q,
+		struct ocf_queue_req_alloc_stats *stats)
+{
+	OCF_CHECK_NULL(q);
+	OCF_CHECK_NULL(stats);
+
+	stats->map_inline = env_atomic64_read(&q->map_inline);
+	stats->map_pool = env_atomic64_read(&q->map_pool);
+	stats->map_fallback = env_atomic64_read(&q->map_fallback);
+	stats->req_allocated = env_atomic64_read(&q->req_allocated);
+	stats->req_recycled = env_atomic64_read(&q->req_recycled);
+}
+
 ocf_cache_t ocf_queue_get_cache(ocf_queue_t q)
 {
 	OCF_CHECK_NULL(q);
@@ -8,15 +8,25 @@
 
 #include "ocf_env.h"
 
+struct ocf_queue_lane {
+	struct list_head io_list;
+
+	/* Number of requests lane may dispatch in a single round */
+	uint32_t weight;
+
+	/* Number of requests left to dispatch in current round */
+	uint32_t credit;
+};
+
+/* Number of request sizes (powers of two up to 128 lines) recycled by queue */
+#define OCF_QUEUE_REQ_CACHE_SIZES 8
+
 struct ocf_queue {
 	ocf_cache_t cache;
 
 	void *priv;
 
-	struct list_head io_list;
-
-	/* per-queue free running global metadata lock index */
-	unsigned lock_idx;
+	struct ocf_queue_lane lanes[ocf_queue_lane_max];
 
 	/* per-queue free running lru list index */
 	unsigned lru_idx;
@@ -34,6 +44,31 @@ struct ocf_queue {
 	env_atomic trace_stop;
 	env_atomic io_no;
 
+	/* Request map allocation counters */
+	env_atomic64 map_inline;
+	env_atomic64 map_pool;
+	env_atomic64 map_fallback;
+
+	/* Completed requests kept for reuse, one list per request size */
+	struct list_head req_cache[OCF_QUEUE_REQ_CACHE_SIZES];
+	env_spinlock req_cache_lock;
+
+	/* Requests put back by completion path, moved to req_cache in
+	 * batches by allocating side */
+	struct list_head req_returned;
+	env_spinlock req_returned_lock;
+
+	/* Number of requests in req_cache and req_returned */
+	env_atomic req_cached;
+
+	env_atomic64 req_allocated;
+	env_atomic64 req_recycled;
+
+	/* Preallocated cache line lock waiters */
+	struct list_head alock_waiters;
+	env_spinlock alock_waiters_lock;
+	void *alock_waiters_mem;
+
 	env_atomic ref_count;
 	env_spinlock io_list_lock;
 } __attribute__((__aligned__(64)));
@@ -6,6 +6,7 @@
 #include "ocf/ocf.h"
 #include "ocf_request.h"
 #include "ocf_cache_priv.h"
+#include "ocf_queue_priv.h"
 #include "concurrency/ocf_metadata_concurrency.h"
 #include "utils/utils_cache_line.h"
 
@@ -32,8 +33,29 @@ enum ocf_req_size {
 	ocf_req_size_32,
 	ocf_req_size_64,
 	ocf_req_size_128,
+	ocf_req_size_256,
+	ocf_req_size_512,
+	ocf_req_size_1024,
 };
 
+/*
+ * Maps of up to ocf_req_size_128 lines normally come inline with request,
+ * so dedicated map pool keeps only small per-CPU reserve for them.
+ */
+#define OCF_REQ_MAP_RPOOL_LIMIT_SMALL 4
+#define OCF_REQ_MAP_RPOOL_NO_LIMIT ((uint32_t)-1)
+
+/* Max number of completed requests kept for reuse by single queue */
+#define OCF_REQ_CACHE_LIMIT 256
+
+static inline unsigned ocf_req_size_idx(uint32_t count)
+{
+	if (count <= 1)
+		return ocf_req_size_1;
+
+	return 32 - __builtin_clz(count - 1);
+}
+
 static inline size_t ocf_req_sizeof_map(struct ocf_request *req)
 {
 	uint32_t lines = req->core_line_count;
@@ -54,22 +76,177 @@ static inline size_t ocf_req_sizeof_alock_status(struct ocf_request *req)
 
 int ocf_req_allocator_init(struct ocf_ctx *ocf_ctx)
 {
+	uint32_t map_limits[env_mpool_max];
+	int i;
+
+	for (i = 0; i < env_mpool_max; i++)
+		map_limits[i] = OCF_REQ_MAP_RPOOL_NO_LIMIT;
+
+	for (i = ocf_req_size_1; i <= ocf_req_size_128; i++)
+		map_limits[i] = OCF_REQ_MAP_RPOOL_LIMIT_SMALL;
+	map_limits[ocf_req_size_256] = 16;
+	map_limits[ocf_req_size_512] = 8;
+	map_limits[ocf_req_size_1024] = 4;
+
+	/* Map pool size classes have to fit env mpool classes */
+	ENV_BUILD_BUG_ON((int)ocf_req_size_1024 >= (int)env_mpool_max);
+
+	/* Keep fast path fields, up to embedded ocf_io, within hot part */
+	ENV_BUILD_BUG_ON(offsetof(struct ocf_request, ioi) +
+			sizeof(struct ocf_io_internal) > OCF_REQ_HOT_SIZE);
+
 	ocf_ctx->resources.req = env_mpool_create(sizeof(struct ocf_request),
 		sizeof(struct ocf_map_info) + sizeof(uint8_t), ENV_MEM_NORMAL, ocf_req_size_128,
 		false, NULL, "ocf_req", true);
 
 	if (ocf_ctx->resources.req == NULL)
-		return -1;
+		goto err;
+
+	/* Map pool does not zero items, only used part of map is cleared */
+	ocf_ctx->resources.req_map = env_mpool_create(0,
+		sizeof(struct ocf_map_info) + sizeof(uint8_t), ENV_MEM_NOIO,
+		ocf_req_size_1024, false, map_limits, "ocf_req_map", false);
+
+	if (ocf_ctx->resources.req_map == NULL)
+		goto err;
 
 	return 0;
+
+err:
+	ocf_req_allocator_deinit(ocf_ctx);
+	return -1;
 }
 
 void ocf_req_allocator_deinit(struct ocf_ctx *ocf_ctx)
 {
+	env_mpool_destroy(ocf_ctx->resources.req_map);
+	ocf_ctx->resources.req_map = NULL;
+
 	env_mpool_destroy(ocf_ctx->resources.req);
 	ocf_ctx->resources.req = NULL;
 }
 
+int ocf_req_cache_init(ocf_queue_t queue)
+{
+	int result;
+	int i;
+
+	ENV_BUILD_BUG_ON(OCF_QUEUE_REQ_CACHE_SIZES != ocf_req_size_128 + 1);
+
+	for (i = 0; i < OCF_QUEUE_REQ_CACHE_SIZES; i++)
+		INIT_LIST_HEAD(&queue->req_cache[i]);
+	INIT_LIST_HEAD(&queue->req_returned);
+	env_atomic_set(&queue->req_cached, 0);
+	env_atomic64_set(&queue->req_allocated, 0);
+	env_atomic64_set(&queue->req_recycled, 0);
+
+	result = env_spinlock_init(&queue->req_cache_lock);
+	if (result)
+		return result;
+
+	result = env_spinlock_init(&queue->req_returned_lock);
+	if (result)
+		env_spinlock_destroy(&queue->req_cache_lock);
+
+	return result;
+}
+
+static void ocf_req_cache_free_list(ocf_cache_t cache, struct list_head *list)
+{
+	struct ocf_request *req, *next;
+
+	list_for_each_entry_safe(req, next, list, list) {
+		list_del(&req->list);
+		env_mpool_del(cache->owner->resources.req, req,
+				req->alloc_core_line_count);
+	}
+}
+
+void ocf_req_cache_deinit(ocf_queue_t queue)
+{
+	int i;
+
+	for (i = 0; i < OCF_QUEUE_REQ_CACHE_SIZES; i++)
+		ocf_req_cache_free_list(queue->cache, &queue->req_cache[i]);
+	ocf_req_cache_free_list(queue->cache, &queue->req_returned);
+
+	env_atomic_set(&queue->req_cached, 0);
+
+	env_spinlock_destroy(&queue->req_returned_lock);
+	env_spinlock_destroy(&queue->req_cache_lock);
+}
+
+/*
+ * Moves all requests returned since last call to per size lists. Called
+ * with req_cache_lock held.
+ */
+static void ocf_req_cache_collect(ocf_queue_t queue)
+{
+	struct ocf_request *req, *next;
+	unsigned long flags;
+
+	env_spinlock_lock_irqsave(&queue->req_returned_lock, flags);
+	list_for_each_entry_safe(req, next, &queue->req_returned, list) {
+		list_move_tail(&req->list, &queue->req_cache[
+				ocf_req_size_idx(req->alloc_core_line_count)]);
+	}
+	env_spinlock_unlock_irqrestore(&queue->req_returned_lock, flags);
+}
+
+static struct ocf_request *ocf_req_cache_get(ocf_queue_t queue,
+		uint32_t count)
+{
+	struct list_head *list = &queue->req_cache[ocf_req_size_idx(count)];
+	struct ocf_request *req = NULL;
+	unsigned long flags;
+
+	if (!env_atomic_read(&queue->req_cached))
+		return NULL;
+
+	env_spinlock_lock_irqsave(&queue->req_cache_lock, flags);
+
+	if (list_empty(list))
+		ocf_req_cache_collect(queue);
+
+	if (!list_empty(list)) {
+		req = list_first_entry(list, struct ocf_request, list);
+		list_del(&req->list);
+		env_atomic_dec(&queue->req_cached);
+	}
+
+	env_spinlock_unlock_irqrestore(&queue->req_cache_lock, flags);
+
+	return req;
+}
+
+static bool ocf_req_cache_put(struct ocf_request *req)
+{
+	ocf_queue_t queue = req->io_queue;
+	unsigned long flags;
+
+	if (env_atomic_inc_return(&queue->req_cached) > OCF_REQ_CACHE_LIMIT) {
+		env_atomic_dec(&queue->req_cached);
+		return false;
+	}
+
+	env_spinlock_lock_irqsave(&queue->req_returned_lock, flags);
+	list_add_tail(&req->list, &queue->req_returned);
+	env_spinlock_unlock_irqrestore(&queue->req_returned_lock, flags);
+
+	return true;
+}
+
+/*
+ * Recycled request is reset like freshly allocated one, but only the part
+ * of inline map which is going to be used is cleared
+ */
+static void ocf_req_reinit(struct ocf_request *req, uint32_t count)
+{
+	ENV_BUG_ON(env_memset(req, offsetof(struct ocf_request, __map), 0));
+	ENV_BUG_ON(env_memset(req->__map, count *
+			(sizeof(struct ocf_map_info) + sizeof(uint8_t)), 0));
+}
+
 struct ocf_request *ocf_req_new(ocf_queue_t queue, ocf_core_t core,
 		uint64_t addr, uint32_t bytes, int rw)
 {
@@ -88,19 +265,34 @@ struct ocf_request *ocf_req_new(ocf_queue_t queue, ocf_core_t core,
 		core_line_count = 1;
 	}
 
-	req = env_mpool_new(cache->owner->resources.req, core_line_count);
-	if (!req) {
+	if (core_line_count > (1 << ocf_req_size_128))
 		map_allocated = false;
-		req = env_mpool_new(cache->owner->resources.req, 1);
-	}
 
-	if (unlikely(!req))
-		return NULL;
+	req = ocf_req_cache_get(queue, map_allocated ? core_line_count : 1);
+	if (req) {
+		ocf_req_reinit(req, map_allocated ? core_line_count : 1);
+		env_atomic64_inc(&queue->req_recycled);
+	} else {
+		if (map_allocated) {
+			req = env_mpool_new(cache->owner->resources.req,
+					core_line_count);
+		}
+		if (!req) {
+			map_allocated = false;
+			req = env_mpool_new(cache->owner->resources.req, 1);
+		}
+
+		if (unlikely(!req))
+			return NULL;
+
+		env_atomic64_inc(&queue->req_allocated);
+	}
 
 	if (map_allocated) {
 		req->map = req->__map;
 		req->alock_status = (uint8_t*)&req->__map[core_line_count];
 		req->alloc_core_line_count = core_line_count;
+		env_atomic64_inc(&queue->map_inline);
 	} else {
 		req->alloc_core_line_count = 1;
 	}
@@ -127,10 +319,6 @@ struct ocf_request *ocf_req_new(ocf_queue_t queue, ocf_core_t core,
 	req->rw = rw;
 	req->part_id = PARTITION_DEFAULT;
 
-	req->discard.sector = BYTES_TO_SECTORS(addr);
-	req->discard.nr_sects = BYTES_TO_SECTORS(bytes);
-	req->discard.handled = 0;
-
 	req->lock_idx = ocf_metadata_concurrency_next_idx(queue);
 
 	return req;
@@ -138,14 +326,26 @@ struct ocf_request *ocf_req_new(ocf_queue_t queue, ocf_core_t core,
 
 int ocf_req_alloc_map(struct ocf_request *req)
 {
+	struct env_mpool *map_pool = req->cache->owner->resources.req_map;
+	size_t size;
+
 	if (req->map)
 		return 0;
 
-	req->map = env_zalloc(ocf_req_sizeof_map(req) +
-			ocf_req_sizeof_alock_status(req), ENV_MEM_NOIO);
-	if (!req->map) {
-		req->error = -OCF_ERR_NO_MEM;
-		return -OCF_ERR_NO_MEM;
+	size = ocf_req_sizeof_map(req) + ocf_req_sizeof_alock_status(req);
+
+	req->map = env_mpool_new(map_pool, req->core_line_count);
+	if (req->map) {
+		ENV_BUG_ON(env_memset(req->map, size, 0));
+		req->map_alloc_count = req->core_line_count;
+		env_atomic64_inc(&req->io_queue->map_pool);
+	} else {
+		req->map = env_zalloc(size, ENV_MEM_NOIO);
+		if (!req->map) {
+			req->error = -OCF_ERR_NO_MEM;
+			return -OCF_ERR_NO_MEM;
+		}
+		env_atomic64_inc(&req->io_queue->map_fallback);
 	}
 
 	req->alock_status = &((uint8_t*)req->map)[ocf_req_sizeof_map(req)];
@@ -199,6 +399,10 @@ struct ocf_request *ocf_req_new_discard(ocf_queue_t queue, ocf_core_t core,
 	if (!req)
 		return NULL;
 
+	req->discard.sector = BYTES_TO_SECTORS(addr);
+	req->discard.nr_sects = BYTES_TO_SECTORS(req->byte_length);
+	req->discard.handled = 0;
+
 	return req;
 }
 
@@ -218,14 +422,22 @@ void ocf_req_put(struct ocf_request *req)
 
 	OCF_DEBUG_TRACE(req->cache);
 
-	if (!req->d2c && req->io_queue != req->cache->mngt_queue)
-		ocf_refcnt_dec(&req->cache->refcnt.metadata);
+	if (!req->d2c && req->io_queue != req->cache->mngt_queue) {
+		if (!ocf_refcnt_dec(&req->cache->refcnt.metadata))
+			ocf_rcu_readers_drained(&req->cache->rcu);
+	}
 
-	if (req->map != req->__map)
+	if (req->map_alloc_count) {
+		env_mpool_del(req->cache->owner->resources.req_map, req->map,
+				req->map_alloc_count);
+	} else if (req->map != req->__map) {
 		env_free(req->map);
+	}
 
-	env_mpool_del(req->cache->owner->resources.req, req,
-			req->alloc_core_line_count);
+	if (!ocf_req_cache_put(req)) {
+		env_mpool_del(req->cache->owner->resources.req, req,
+				req->alloc_core_line_count);
+	}
 
 	ocf_queue_put(queue);
 }
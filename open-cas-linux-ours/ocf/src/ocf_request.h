@@ -45,6 +45,10 @@ struct ocf_req_info {
 
 	uint32_t internal : 1;
 	/**!< this is an internal request */
+
+	uint32_t resume_unlocked : 1;
+	/**!< Cache line lock was granted by a context holding no other
+	 * locks, so request may be resumed inline */
 };
 
 struct ocf_map_info {
@@ -96,10 +100,15 @@ struct ocf_req_discard_info {
 
 /**
  * @brief OCF IO request
+ *
+ * Fields are ordered by access frequency. First OCF_REQ_HOT_SIZE bytes hold
+ * everything touched by fast path submission and completion - including
+ * request info and the embedded ocf_io through which request enters and
+ * leaves OCF. The rest is only accessed by engine slow paths, cleaner,
+ * discard and metadata I/O.
  */
 struct ocf_request {
-	struct ocf_io_internal ioi;
-	/*!< OCF IO associated with request */
+	/* Hot: fast path submission and completion */
 
 	env_atomic ref_count;
 	/*!< Reference usage count, once OCF request reaches zero it
@@ -107,21 +116,18 @@ struct ocf_request {
 	 * reference counter
 	 */
 
-	env_atomic lock_remaining;
-	/*!< This filed indicates how many cache lines in the request
-	 * map left to be locked
-	 */
-
 	env_atomic req_remaining;
 	/*!< In case of IO this field indicates how many IO left to
 	 * accomplish IO
 	 */
 
-	env_atomic master_remaining;
-	/*!< Atomic counter for core device */
+	env_atomic lock_remaining;
+	/*!< This filed indicates how many cache lines in the request
+	 * map left to be locked
+	 */
 
-	const struct ocf_engine_callbacks *engine_cbs;
-	/*!< Engine owning the request */
+	int error;
+	/*!< This filed indicates an error for OCF request */
 
 	ocf_cache_t cache;
 	/*!< Handle to cache instance */
@@ -129,21 +135,15 @@ struct ocf_request {
 	ocf_core_t core;
 	/*!< Handle to core instance */
 
+	ocf_queue_t io_queue;
+	/*!< I/O queue handle for which request should be submitted */
+
 	const struct ocf_io_if *io_if;
 	/*!< IO interface */
 
-	void *priv;
-	/*!< Filed for private data, context */
-
-	void *master_io_req;
-	/*!< Core device request context (core private info) */
-
 	ctx_data_t *data;
 	/*!< Request data*/
 
-	ctx_data_t *cp_data;
-	/*!< Copy of request data */
-
 	uint64_t byte_position;
 	/*!< LBA byte position of request in core domain */
 
@@ -159,11 +159,10 @@ struct ocf_request {
 	uint32_t core_line_count;
 	/*! Core line count */
 
-	uint32_t alloc_core_line_count;
-	/*! Number of core lines at time of request allocation */
+	struct ocf_map_info *map;
 
-	int error;
-	/*!< This filed indicates an error for OCF request */
+	uint8_t *alock_status;
+	/*!< Mapping for locked/unlocked alock entries */
 
 	ocf_part_id_t part_id;
 	/*!< Targeted partition of requests */
@@ -201,36 +200,59 @@ struct ocf_request {
 	uint8_t lock_idx : OCF_METADATA_GLOBAL_LOCK_IDX_BITS;
 	/* !< Selected global metadata read lock */
 
+	uint8_t alock_rw : 1;
+	/*!< Read/Write mode for alock*/
+
 	ocf_req_cache_mode_t cache_mode;
 
-	uint64_t timestamp;
-	/*!< Tracing timestamp */
+	void (*complete)(struct ocf_request *ocf_req, int error);
+	/*!< Request completion function */
 
-	ocf_queue_t io_queue;
-	/*!< I/O queue handle for which request should be submitted */
+	uint32_t alloc_core_line_count;
+	/*! Number of core lines at time of request allocation */
 
-	struct list_head list;
-	/*!< List item for OCF IO thread workers */
+	uint32_t map_alloc_count;
+	/*! Number of map entries taken from map pool, 0 if not pooled */
 
 	struct ocf_req_info info;
 	/*!< Detailed request info */
 
-	void (*complete)(struct ocf_request *ocf_req, int error);
-	/*!< Request completion function */
+	struct list_head list;
+	/*!< List item for OCF IO thread workers and request free lists */
 
-	struct ocf_req_discard_info discard;
+	struct ocf_io_internal ioi;
+	/*!< OCF IO associated with request, reached via container_of */
 
-	uint32_t alock_rw;
-	/*!< Read/Write mode for alock*/
+	/* Warm: engine traverse and cleaner */
 
-	uint8_t *alock_status;
-	/*!< Mapping for locked/unlocked alock entries */
+	const struct ocf_engine_callbacks *engine_cbs;
+	/*!< Engine owning the request */
 
-	struct ocf_map_info *map;
+	env_atomic master_remaining;
+	/*!< Atomic counter for core device */
+
+	void *master_io_req;
+	/*!< Core device request context (core private info) */
+
+	/* Cold: discard, private data and metadata I/O */
+
+	void *priv;
+	/*!< Filed for private data, context */
+
+	ctx_data_t *cp_data;
+	/*!< Copy of request data */
+
+	uint64_t timestamp;
+	/*!< Tracing timestamp */
+
+	struct ocf_req_discard_info discard;
 
 	struct ocf_map_info __map[0];
 };
 
+/* Bytes of ocf_request holding fast path fields */
+#define OCF_REQ_HOT_SIZE 320
+
 typedef void (*ocf_req_end_t)(struct ocf_request *req, int error);
 
 /**
@@ -248,6 +270,22 @@ int ocf_req_allocator_init(struct ocf_ctx *ocf_ctx);
  */
 void ocf_req_allocator_deinit(struct ocf_ctx *ocf_ctx);
 
+/**
+ * @brief Initialize I/O queue request free lists
+ *
+ * @param queue - I/O queue handle
+ *
+ * @return Operation status 0 - successful, non-zero failure
+ */
+int ocf_req_cache_init(ocf_queue_t queue);
+
+/**
+ * @brief Release requests kept on I/O queue free lists
+ *
+ * @param queue - I/O queue handle
+ */
+void ocf_req_cache_deinit(ocf_queue_t queue);
+
 /**
  * @brief Allocate new OCF request
  *
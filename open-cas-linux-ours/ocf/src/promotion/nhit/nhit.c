@@ -13,8 +13,13 @@
 
 #define NHIT_MAPPING_RATIO 2
 
+/* Smallest hash allowed when fitting into memory budget, as cachelines
+ * divider */
+#define NHIT_MAPPING_MIN_DIVIDER 8
+
 struct nhit_policy_context {
 	nhit_hash_t hash_map;
+	uint64_t hash_size;
 };
 
 void nhit_setup(ocf_cache_t cache)
@@ -27,26 +32,70 @@ void nhit_setup(ocf_cache_t cache)
 	cfg->trigger_threshold = OCF_NHIT_TRIGGER_DEFAULT;
 }
 
-static uint64_t nhit_sizeof(ocf_cache_t cache)
+static uint64_t nhit_sizeof(uint64_t hash_size)
 {
 	uint64_t size = 0;
 
 	size += sizeof(struct nhit_policy_context);
-	size += nhit_hash_sizeof(ocf_metadata_get_cachelines_count(cache) *
-			NHIT_MAPPING_RATIO);
+	size += nhit_hash_sizeof(hash_size);
 
 	return size;
 }
 
-ocf_error_t nhit_init(ocf_cache_t cache)
+/*
+ * Pick hash size. With memory budget set, hash is shrunk until it fits into
+ * what is left of the budget after metadata and cleaning policy, trading
+ * accuracy of hit tracking for memory.
+ */
+static uint64_t nhit_hash_size(ocf_cache_t cache, uint64_t *budget)
 {
+	struct ocf_cache_memory_footprint footprint;
+	uint64_t cachelines = ocf_metadata_get_cachelines_count(cache);
+	uint64_t hash_size = cachelines * NHIT_MAPPING_RATIO;
+	uint64_t min_hash_size;
+	uint64_t used;
+
+	*budget = 0;
+	if (!cache->memory_budget)
+		return hash_size;
+
+	ocf_cache_get_memory_footprint(cache, &footprint);
+	used = footprint.total - footprint.promotion_policy;
+	if (used < cache->memory_budget)
+		*budget = cache->memory_budget - used;
+
+	min_hash_size = OCF_MAX(OCF_DIV_ROUND_UP(cachelines,
+			NHIT_MAPPING_MIN_DIVIDER), 1);
+
+	while (hash_size / 2 >= min_hash_size &&
+			nhit_sizeof(hash_size) > *budget) {
+		hash_size /= 2;
+	}
+
+	return hash_size;
+}
+
+ocf_error_t nhit_init(ocf_promotion_policy_t policy)
+{
+	ocf_cache_t cache = policy->owner;
 	struct nhit_policy_context *ctx;
 	int result = 0;
-	uint64_t available, size;
+	uint64_t available, size, hash_size, budget;
 
-	size = nhit_sizeof(cache);
+	hash_size = nhit_hash_size(cache, &budget);
+	size = nhit_sizeof(hash_size);
 	available = env_get_free_memory();
 
+	if (cache->memory_budget && size > budget) {
+		ocf_cache_log(cache, log_err, "'nhit' promotion policy does "
+				"not fit into memory budget! "
+				"Required %lu, left in budget %lu\n",
+				(long unsigned)size,
+				(long unsigned)budget);
+
+		return -OCF_ERR_NO_FREE_RAM;
+	}
+
 	if (size >= available) {
 		ocf_cache_log(cache, log_err, "Not enough memory to "
 				"initialize 'nhit' promotion policy! "
@@ -63,13 +112,21 @@ ocf_error_t nhit_init(ocf_cache_t cache)
 		goto exit;
 	}
 
-	result = nhit_hash_init(ocf_metadata_get_cachelines_count(cache) *
-			NHIT_MAPPING_RATIO, &ctx->hash_map);
+	result = nhit_hash_init(hash_size, &ctx->hash_map);
 	if (result)
 		goto dealloc_ctx;
 
-	cache->promotion_policy->ctx = ctx;
-	cache->promotion_policy->config =
+	ctx->hash_size = hash_size;
+
+	if (hash_size < ocf_metadata_get_cachelines_count(cache) *
+			NHIT_MAPPING_RATIO) {
+		ocf_cache_log(cache, log_info, "'nhit' hash reduced to %llu "
+				"entries to fit memory budget\n",
+				(unsigned long long)hash_size);
+	}
+
+	policy->ctx = ctx;
+	policy->config =
 		(void *) &cache->conf_meta->promotion[ocf_promotion_nhit].data;
 
 	return 0;
@@ -91,6 +148,13 @@ void nhit_deinit(ocf_promotion_policy_t policy)
 	policy->ctx = NULL;
 }
 
+uint64_t nhit_size_of(ocf_promotion_policy_t policy)
+{
+	struct nhit_policy_context *ctx = policy->ctx;
+
+	return nhit_sizeof(ctx->hash_size);
+}
+
 ocf_error_t nhit_set_param(ocf_cache_t cache, uint8_t param_id,
 		uint32_t param_value)
 {
@@ -13,7 +13,7 @@
 
 void nhit_setup(ocf_cache_t cache);
 
-ocf_error_t nhit_init(ocf_cache_t cache);
+ocf_error_t nhit_init(ocf_promotion_policy_t policy);
 
 void nhit_deinit(ocf_promotion_policy_t policy);
 
@@ -29,4 +29,6 @@ void nhit_req_purge(ocf_promotion_policy_t policy,
 bool nhit_req_should_promote(ocf_promotion_policy_t policy,
 		struct ocf_request *req);
 
+uint64_t nhit_size_of(ocf_promotion_policy_t policy);
+
 #endif /* NHIT_PROMOTION_POLICY_H_ */
@@ -7,6 +7,7 @@
 #define PROMOTION_OPS_H_
 
 #include "../metadata/metadata.h"
+#include "../utils/utils_rcu.h"
 #include "promotion.h"
 
 struct ocf_promotion_policy {
@@ -18,6 +19,9 @@ struct ocf_promotion_policy {
 	/* Pointer to config values stored in cache superblock */
 
 	void *ctx;
+
+	struct ocf_rcu_head rcu;
+	/* Used to free policy once it's no longer visible to requests */
 };
 
 struct promotion_policy_ops {
@@ -27,7 +31,7 @@ struct promotion_policy_ops {
 	void (*setup)(ocf_cache_t cache);
 		/*!< initialize promotion policy default config */
 
-	ocf_error_t (*init)(ocf_cache_t cache);
+	ocf_error_t (*init)(ocf_promotion_policy_t policy);
 		/*!< Allocate and initialize promotion policy */
 
 	void (*deinit)(ocf_promotion_policy_t policy);
@@ -49,6 +53,9 @@ struct promotion_policy_ops {
 	bool (*req_should_promote)(ocf_promotion_policy_t policy,
 			struct ocf_request *req);
 		/*!< Should request lines be inserted into cache */
+
+	uint64_t (*size_of)(ocf_promotion_policy_t policy);
+		/*!< Memory used by initialized promotion policy */
 };
 
 extern struct promotion_policy_ops ocf_promotion_policies[ocf_promotion_max];
@@ -4,6 +4,7 @@
  */
 
 #include "../metadata/metadata.h"
+#include "../concurrency/ocf_metadata_concurrency.h"
 
 #include "promotion.h"
 #include "ops.h"
@@ -22,42 +23,61 @@ struct promotion_policy_ops ocf_promotion_policies[ocf_promotion_max] = {
 		.get_param = nhit_get_param,
 		.req_purge = nhit_req_purge,
 		.req_should_promote = nhit_req_should_promote,
+		.size_of = nhit_size_of,
 	},
 };
 
-ocf_error_t ocf_promotion_init(ocf_cache_t cache, ocf_promotion_t type)
+static ocf_error_t _ocf_promotion_create(ocf_cache_t cache,
+		ocf_promotion_t type, ocf_promotion_policy_t *policy)
 {
-	ocf_promotion_policy_t policy;
+	ocf_promotion_policy_t tmp_policy;
 	ocf_error_t result = 0;
 
-	ENV_BUG_ON(type >= ocf_promotion_max);
-
-	policy = env_vmalloc(sizeof(*policy));
-	if (!policy)
+	tmp_policy = env_vmalloc(sizeof(*tmp_policy));
+	if (!tmp_policy)
 		return -OCF_ERR_NO_MEM;
 
-	policy->type = type;
-	policy->owner = cache;
-	policy->config =
+	tmp_policy->type = type;
+	tmp_policy->owner = cache;
+	tmp_policy->ctx = NULL;
+	tmp_policy->config =
 		(void *)&cache->conf_meta->promotion[type].data;
-	cache->promotion_policy = policy;
 
 	if (ocf_promotion_policies[type].init)
-		result = ocf_promotion_policies[type].init(cache);
+		result = ocf_promotion_policies[type].init(tmp_policy);
+
+	if (result) {
+		env_vfree(tmp_policy);
+		return result;
+	}
+
+	*policy = tmp_policy;
+
+	return 0;
+}
+
+ocf_error_t ocf_promotion_init(ocf_cache_t cache, ocf_promotion_t type)
+{
+	ocf_promotion_policy_t policy;
+	ocf_error_t result;
+
+	ENV_BUG_ON(type >= ocf_promotion_max);
 
+	result = _ocf_promotion_create(cache, type, &policy);
 	if (result) {
-		env_vfree(cache->promotion_policy);
-		cache->promotion_policy = NULL;
 		ocf_cache_log(cache, log_info,
 				"Policy '%s' failed to initialize\n",
 				ocf_promotion_policies[type].name);
-	} else {
-		ocf_cache_log(cache, log_info,
-				"Policy '%s' initialized successfully\n",
-				ocf_promotion_policies[type].name);
+		return result;
 	}
 
-	return result;
+	cache->promotion_policy = policy;
+
+	ocf_cache_log(cache, log_info,
+			"Policy '%s' initialized successfully\n",
+			ocf_promotion_policies[type].name);
+
+	return 0;
 }
 
 void ocf_promotion_deinit(ocf_promotion_policy_t policy)
@@ -72,47 +92,56 @@ void ocf_promotion_deinit(ocf_promotion_policy_t policy)
 	env_vfree(policy);
 }
 
+static void _ocf_promotion_retire(struct ocf_rcu_head *head)
+{
+	ocf_promotion_policy_t policy = container_of(head,
+			struct ocf_promotion_policy, rcu);
+
+	ocf_promotion_deinit(policy);
+}
+
 ocf_error_t ocf_promotion_set_policy(ocf_promotion_policy_t policy,
 		ocf_promotion_t type)
 {
-	ocf_error_t result = 0;
 	ocf_cache_t cache = policy->owner;
-	ocf_promotion_t prev_policy;
+	ocf_promotion_policy_t new_policy;
+	ocf_error_t result;
 
 	if (type >= ocf_promotion_max)
 		return -OCF_ERR_INVAL;
 
-	prev_policy = cache->conf_meta->promotion_policy_type;
-
-	if (type == prev_policy) {
+	if (type == cache->conf_meta->promotion_policy_type) {
 		ocf_cache_log(cache, log_info, "Promotion policy '%s' is already set\n",
 			      ocf_promotion_policies[type].name);
 		return 0;
 	}
 
-	if (ocf_promotion_policies[prev_policy].deinit)
-		ocf_promotion_policies[prev_policy].deinit(policy);
-
-	cache->conf_meta->promotion_policy_type = type;
-	policy->type = type;
-
-	if (ocf_promotion_policies[type].init)
-		result = ocf_promotion_policies[type].init(cache);
-
+	result = _ocf_promotion_create(cache, type, &new_policy);
 	if (result) {
 		ocf_cache_log(cache, log_err,
 				"Error switching to new promotion policy\n");
-		ocf_cache_log(cache, log_err,
-				"Falling back to 'always' promotion policy\n");
-		cache->conf_meta->promotion_policy_type = ocf_promotion_always;
-		policy->type = ocf_promotion_always;
-	} else {
-		ocf_cache_log(cache, log_info,
-				"Switched to '%s' promotion policy\n",
-				ocf_promotion_policies[type].name);
+		ocf_cache_log(cache, log_err, "Keeping '%s' promotion policy\n",
+				ocf_promotion_policies[policy->type].name);
+		return result;
 	}
 
-	return result;
+	/* Requests pick up new policy on next lookup, old one is freed once
+	 * none of the requests that might still use it is in flight */
+	env_smp_wmb();
+	cache->promotion_policy = new_policy;
+	cache->conf_meta->promotion_policy_type = type;
+
+	if (ocf_rcu_call(&cache->rcu, &policy->rcu, _ocf_promotion_retire)) {
+		/* Can't start grace period - wait for readers synchronously */
+		ocf_metadata_start_exclusive_access(&cache->metadata.lock);
+		ocf_metadata_end_exclusive_access(&cache->metadata.lock);
+		ocf_promotion_deinit(policy);
+	}
+
+	ocf_cache_log(cache, log_info, "Switched to '%s' promotion policy\n",
+			ocf_promotion_policies[type].name);
+
+	return 0;
 }
 
 ocf_error_t ocf_promotion_set_param(ocf_cache_t cache, ocf_promotion_t type,
@@ -172,3 +201,14 @@ bool ocf_promotion_req_should_promote(ocf_promotion_policy_t policy,
 	return result;
 }
 
+uint64_t ocf_promotion_size_of(ocf_promotion_policy_t policy)
+{
+	ocf_promotion_t type = policy->type;
+
+	ENV_BUG_ON(type >= ocf_promotion_max);
+
+	if (!ocf_promotion_policies[type].size_of || !policy->ctx)
+		return 0;
+
+	return ocf_promotion_policies[type].size_of(policy);
+}
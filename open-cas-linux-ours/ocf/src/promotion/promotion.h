@@ -50,7 +50,9 @@ ocf_error_t ocf_promotion_init(ocf_cache_t cache, ocf_promotion_t type);
 void ocf_promotion_deinit(ocf_promotion_policy_t policy);
 
 /**
- * @brief Switch promotion policy to type. On failure will fall back to 'always'
+ * @brief Switch promotion policy to type. New policy is published without
+ * stopping I/O and old one is freed after grace period. On failure current
+ * policy is kept
  *
  * @param[in] policy promotion policy handle
  * @param[in] type promotion policy target type
@@ -108,4 +110,13 @@ void ocf_promotion_req_purge(ocf_promotion_policy_t policy,
 bool ocf_promotion_req_should_promote(ocf_promotion_policy_t policy,
 		struct ocf_request *req);
 
+/**
+ * @brief Get memory used by promotion policy runtime structures
+ *
+ * @param[in] policy promotion policy handle
+ *
+ * @retval size in bytes
+ */
+uint64_t ocf_promotion_size_of(ocf_promotion_policy_t policy);
+
 #endif /* PROMOTION_H_ */
@@ -6,6 +6,7 @@
 #include "../ocf_cache_priv.h"
 #include "../ocf_priv.h"
 #include "../ocf_request.h"
+#include "../ocf_queue_priv.h"
 #include "utils_alock.h"
 
 #define OCF_CACHE_CONCURRENCY_DEBUG 0
@@ -41,6 +42,9 @@
 
 #define _WAITERS_LIST_ITEM(entry) ((entry) % _WAITERS_LIST_ENTRIES)
 
+/* Number of waiters preallocated for each I/O queue */
+#define _WAITERS_QUEUE_POOL_SIZE	128
+
 struct ocf_alock_waiter {
 	ocf_cache_line_t entry;
 	uint32_t idx;
@@ -48,6 +52,8 @@ struct ocf_alock_waiter {
 	ocf_req_async_lock_cb cmpl;
 	struct list_head item;
 	int rw;
+	ocf_queue_t pool; /* Owning queue pool, NULL if taken from allocator */
+	uint64_t wait_start;
 };
 
 struct ocf_alock_waiters_list {
@@ -66,10 +72,111 @@ struct ocf_alock {
 	env_atomic *access;
 	env_allocator *allocator;
 	struct ocf_alock_lock_cbs *cbs;
+
+	struct {
+		env_atomic64 waits;
+		env_atomic64 wait_ns;
+		env_atomic64 waiter_allocs;
+	} stats __attribute__((__aligned__(64)));
+
 	struct ocf_alock_waiters_list waiters_lsts[_WAITERS_LIST_ENTRIES];
 
 } __attribute__((__aligned__(64)));
 
+int ocf_alock_waiter_pool_init(ocf_queue_t queue)
+{
+	struct ocf_alock_waiter *waiters;
+	int result;
+	int i;
+
+	INIT_LIST_HEAD(&queue->alock_waiters);
+
+	result = env_spinlock_init(&queue->alock_waiters_lock);
+	if (result)
+		return result;
+
+	waiters = env_zalloc(sizeof(*waiters) * _WAITERS_QUEUE_POOL_SIZE,
+			ENV_MEM_NORMAL);
+	if (!waiters) {
+		env_spinlock_destroy(&queue->alock_waiters_lock);
+		return -OCF_ERR_NO_MEM;
+	}
+
+	for (i = 0; i < _WAITERS_QUEUE_POOL_SIZE; i++) {
+		waiters[i].pool = queue;
+		list_add_tail(&waiters[i].item, &queue->alock_waiters);
+	}
+
+	queue->alock_waiters_mem = waiters;
+
+	return 0;
+}
+
+void ocf_alock_waiter_pool_deinit(ocf_queue_t queue)
+{
+	env_free(queue->alock_waiters_mem);
+	queue->alock_waiters_mem = NULL;
+	env_spinlock_destroy(&queue->alock_waiters_lock);
+}
+
+/*
+ * Waiters are taken from the pool of the queue request is processed on and
+ * fall back to the allocator only when the pool is exhausted.
+ */
+static struct ocf_alock_waiter *ocf_alock_waiter_new(struct ocf_alock *alock,
+		struct ocf_request *req)
+{
+	ocf_queue_t queue = req->io_queue;
+	struct ocf_alock_waiter *waiter = NULL;
+	unsigned long flags = 0;
+
+	if (queue && queue->alock_waiters_mem) {
+		env_spinlock_lock_irqsave(&queue->alock_waiters_lock, flags);
+		if (!list_empty(&queue->alock_waiters)) {
+			waiter = list_first_entry(&queue->alock_waiters,
+					struct ocf_alock_waiter, item);
+			list_del(&waiter->item);
+		}
+		env_spinlock_unlock_irqrestore(&queue->alock_waiters_lock,
+				flags);
+	}
+
+	if (waiter)
+		return waiter;
+
+	waiter = env_allocator_new(alock->allocator);
+	if (waiter) {
+		waiter->pool = NULL;
+		env_atomic64_inc(&alock->stats.waiter_allocs);
+	}
+
+	return waiter;
+}
+
+static void ocf_alock_waiter_del(struct ocf_alock *alock,
+		struct ocf_alock_waiter *waiter)
+{
+	ocf_queue_t queue = waiter->pool;
+	unsigned long flags = 0;
+
+	if (!queue) {
+		env_allocator_del(alock->allocator, waiter);
+		return;
+	}
+
+	env_spinlock_lock_irqsave(&queue->alock_waiters_lock, flags);
+	list_add(&waiter->item, &queue->alock_waiters);
+	env_spinlock_unlock_irqrestore(&queue->alock_waiters_lock, flags);
+}
+
+void ocf_alock_get_stats(struct ocf_alock *alock,
+		struct ocf_cache_lock_stats *stats)
+{
+	stats->waits = env_atomic64_read(&alock->stats.waits);
+	stats->wait_time_ns = env_atomic64_read(&alock->stats.wait_ns);
+	stats->waiter_allocs = env_atomic64_read(&alock->stats.waiter_allocs);
+}
+
 void ocf_alock_mark_index_locked(struct ocf_alock *alock,
 		struct ocf_request *req, unsigned index, bool locked)
 {
@@ -102,6 +209,10 @@ int ocf_alock_init_inplace(struct ocf_alock *self, unsigned num_entries,
 	self->num_entries = num_entries;
 	self->cbs = cbs;
 
+	env_atomic64_set(&self->stats.waits, 0);
+	env_atomic64_set(&self->stats.wait_ns, 0);
+	env_atomic64_set(&self->stats.waiter_allocs, 0);
+
 	error = env_mutex_init(&self->lock);
 	if (error) {
 		error = __LINE__;
@@ -291,6 +402,60 @@ static inline bool ocf_alock_trylock_entry_rd(struct ocf_alock *alock,
 	return !!env_atomic_add_unless(access, 1, OCF_CACHE_LINE_ACCESS_WR);
 }
 
+/*
+ * Read lock attempt for request fast path. As long as no request waits for
+ * any entry of this alock, reader can simply join other readers. Otherwise
+ * only idle entry is taken, so that readers don't overtake queued writers.
+ */
+bool ocf_alock_trylock_entry_rd_fast(struct ocf_alock *alock,
+		ocf_cache_line_t entry)
+{
+	if (env_atomic_read(&alock->waiting))
+		return ocf_alock_trylock_entry_rd_idle(alock, entry);
+
+	return ocf_alock_trylock_entry_rd(alock, entry);
+}
+
+/*
+ * Lock physically contiguous range of entries without waiting. Entries are
+ * walked sequentially through the access array and the waiting state is
+ * sampled once for the whole range. On failure all entries locked so far
+ * are released and waiters granted by that are added to @granted, to be
+ * resumed by the caller once rollback is complete.
+ */
+bool ocf_alock_trylock_range(struct ocf_alock *alock,
+		ocf_cache_line_t entry, uint32_t count, int rw,
+		struct list_head *granted)
+{
+	bool shared = (rw == OCF_READ) && !env_atomic_read(&alock->waiting);
+	bool locked;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		if (rw == OCF_WRITE)
+			locked = ocf_alock_trylock_entry_wr(alock, entry + i);
+		else if (shared)
+			locked = ocf_alock_trylock_entry_rd(alock, entry + i);
+		else
+			locked = ocf_alock_trylock_entry_rd_idle(alock, entry + i);
+
+		if (!locked)
+			break;
+	}
+
+	if (i == count)
+		return true;
+
+	while (i--) {
+		if (rw == OCF_WRITE)
+			ocf_alock_unlock_one_wr_deferred(alock, entry + i, granted);
+		else
+			ocf_alock_unlock_one_rd_deferred(alock, entry + i, granted);
+	}
+
+	return false;
+}
+
 static inline void ocf_alock_unlock_entry_wr(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
@@ -374,6 +539,58 @@ static void ocf_alock_entry_locked(struct ocf_alock *alock,
 	}
 }
 
+/*
+ * Account lock granted to waiter during unlock. Returns true if all entries
+ * of waiting request are locked and request needs to be resumed.
+ */
+static inline bool ocf_alock_waiter_locked(struct ocf_alock *alock,
+		struct ocf_alock_waiter *waiter)
+{
+	env_atomic64_add(env_ticks_to_nsecs(env_get_tick_count() -
+			waiter->wait_start), &alock->stats.wait_ns);
+
+	ocf_alock_mark_index_locked(alock, waiter->req, waiter->idx, true);
+
+	if (env_atomic_dec_return(&waiter->req->lock_remaining) == 0) {
+		env_atomic_dec(&alock->waiting);
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * Resume requests which got all entries locked during unlock. This is called
+ * after waiters list lock is released, so resume callbacks are not executed
+ * with the spinlock held and interrupts disabled. @unlocked tells resumed
+ * requests that the caller holds no other locks.
+ */
+void ocf_alock_waiters_resume(struct ocf_alock *alock,
+		struct list_head *granted, bool unlocked)
+{
+	struct ocf_alock_waiter *waiter;
+	struct list_head *iter, *next;
+	struct ocf_request *req;
+	ocf_req_async_lock_cb cmpl;
+
+	list_for_each_safe(iter, next, granted) {
+		waiter = list_entry(iter, struct ocf_alock_waiter, item);
+		list_del(iter);
+
+		req = waiter->req;
+		cmpl = waiter->cmpl;
+
+		/* Return waiter before resuming, as the request may complete
+		 * and release its queue from within completion callback */
+		ocf_alock_waiter_del(alock, waiter);
+
+		OCF_DEBUG_RQ(req, "Resume");
+		ENV_BUG_ON(!cmpl);
+		req->info.resume_unlocked = unlocked;
+		cmpl(req);
+	}
+}
+
 bool ocf_alock_lock_one_wr(struct ocf_alock *alock,
 		const ocf_cache_line_t entry, ocf_req_async_lock_cb cmpl,
 		void *req, uint32_t idx)
@@ -391,7 +608,7 @@ bool ocf_alock_lock_one_wr(struct ocf_alock *alock,
 		return true;
 	}
 
-	waiter = env_allocator_new(alock->allocator);
+	waiter = ocf_alock_waiter_new(alock, req);
 	if (!waiter)
 		return false;
 
@@ -409,19 +626,22 @@ bool ocf_alock_lock_one_wr(struct ocf_alock *alock,
 	waiter->idx = idx;
 	waiter->cmpl = cmpl;
 	waiter->rw = OCF_WRITE;
+	waiter->wait_start = env_get_tick_count();
 	INIT_LIST_HEAD(&waiter->item);
 
 	/* Add to waiters list */
 	ocf_alock_waitlist_add(alock, entry, waiter);
+	env_atomic64_inc(&alock->stats.waits);
 	waiting = true;
 
 unlock:
 	ocf_alock_waitlist_unlock(alock, entry, flags);
 
 	if (!waiting) {
+		/* Waiter must not outlive request resumed below */
+		ocf_alock_waiter_del(alock, waiter);
 		ocf_alock_mark_index_locked(alock, req, idx, true);
 		ocf_alock_entry_locked(alock, req, cmpl);
-		env_allocator_del(alock->allocator, waiter);
 	}
 
 	return true;
@@ -448,7 +668,7 @@ bool ocf_alock_lock_one_rd(struct ocf_alock *alock,
 		return true;
 	}
 
-	waiter = env_allocator_new(alock->allocator);
+	waiter = ocf_alock_waiter_new(alock, req);
 	if (!waiter)
 		return false;
 
@@ -471,19 +691,22 @@ bool ocf_alock_lock_one_rd(struct ocf_alock *alock,
 	waiter->idx = idx;
 	waiter->cmpl = cmpl;
 	waiter->rw = OCF_READ;
+	waiter->wait_start = env_get_tick_count();
 	INIT_LIST_HEAD(&waiter->item);
 
 	/* Add to waiters list */
 	ocf_alock_waitlist_add(alock, entry, waiter);
+	env_atomic64_inc(&alock->stats.waits);
 	waiting = true;
 
 unlock:
 	ocf_alock_waitlist_unlock(alock, entry, flags);
 
 	if (!waiting) {
+		/* Waiter must not outlive request resumed below */
+		ocf_alock_waiter_del(alock, waiter);
 		ocf_alock_mark_index_locked(alock, req, idx, true);
 		ocf_alock_entry_locked(alock, req, cmpl);
-		env_allocator_del(alock->allocator, waiter);
 	}
 
 	return true;
@@ -495,7 +718,7 @@ unlock:
  * or kept as a readlock. If there are no waiters, it's just unlocked.
  */
 static inline void ocf_alock_unlock_one_rd_common(struct ocf_alock *alock,
-		const ocf_cache_line_t entry)
+		const ocf_cache_line_t entry, struct list_head *granted)
 {
 	bool locked = false;
 	bool exchanged = true;
@@ -540,10 +763,10 @@ static inline void ocf_alock_unlock_one_rd_common(struct ocf_alock *alock,
 			exchanged = false;
 			list_del(iter);
 
-			ocf_alock_mark_index_locked(alock, waiter->req, waiter->idx, true);
-			ocf_alock_entry_locked(alock, waiter->req, waiter->cmpl);
-
-			env_allocator_del(alock->allocator, waiter);
+			if (ocf_alock_waiter_locked(alock, waiter))
+				list_add_tail(iter, granted);
+			else
+				ocf_alock_waiter_del(alock, waiter);
 		} else {
 			break;
 		}
@@ -563,8 +786,12 @@ bool ocf_alock_trylock_one_rd(struct ocf_alock *alock,
 	return ocf_alock_trylock_entry_rd_idle(alock, entry);
 }
 
-void ocf_alock_unlock_one_rd(struct ocf_alock *alock,
-		const ocf_cache_line_t entry)
+/*
+ * Release entry without resuming waiters it was handed over to - they are
+ * added to @granted and must be passed to ocf_alock_waiters_resume().
+ */
+void ocf_alock_unlock_one_rd_deferred(struct ocf_alock *alock,
+		const ocf_cache_line_t entry, struct list_head *granted)
 {
 	unsigned long flags = 0;
 
@@ -572,17 +799,29 @@ void ocf_alock_unlock_one_rd(struct ocf_alock *alock,
 
 	/* Lock waiters list */
 	ocf_alock_waitlist_lock(alock, entry, flags);
-	ocf_alock_unlock_one_rd_common(alock, entry);
+	ocf_alock_unlock_one_rd_common(alock, entry, granted);
 	ocf_alock_waitlist_unlock(alock, entry, flags);
 }
 
+void ocf_alock_unlock_one_rd(struct ocf_alock *alock,
+		const ocf_cache_line_t entry)
+{
+	struct list_head granted;
+
+	INIT_LIST_HEAD(&granted);
+
+	ocf_alock_unlock_one_rd_deferred(alock, entry, &granted);
+
+	ocf_alock_waiters_resume(alock, &granted, false);
+}
+
 /*
  * Unlocks the given write lock. If any waiters are registered for the same
  * cacheline, one is awakened and the lock is either downgraded to a readlock
  * or kept as a writelock. If there are no waiters, it's just unlocked.
  */
 static inline void ocf_alock_unlock_one_wr_common(struct ocf_alock *alock,
-		const ocf_cache_line_t entry)
+		const ocf_cache_line_t entry, struct list_head *granted)
 {
 	bool locked = false;
 	bool exchanged = true;
@@ -627,10 +866,10 @@ static inline void ocf_alock_unlock_one_wr_common(struct ocf_alock *alock,
 			exchanged = false;
 			list_del(iter);
 
-			ocf_alock_mark_index_locked(alock, waiter->req, waiter->idx, true);
-			ocf_alock_entry_locked(alock, waiter->req, waiter->cmpl);
-
-			env_allocator_del(alock->allocator, waiter);
+			if (ocf_alock_waiter_locked(alock, waiter))
+				list_add_tail(iter, granted);
+			else
+				ocf_alock_waiter_del(alock, waiter);
 		} else {
 			break;
 		}
@@ -644,8 +883,12 @@ static inline void ocf_alock_unlock_one_wr_common(struct ocf_alock *alock,
 	}
 }
 
-void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
-		const ocf_cache_line_t entry)
+/*
+ * Release entry without resuming waiters it was handed over to - they are
+ * added to @granted and must be passed to ocf_alock_waiters_resume().
+ */
+void ocf_alock_unlock_one_wr_deferred(struct ocf_alock *alock,
+		const ocf_cache_line_t entry, struct list_head *granted)
 {
 	unsigned long flags = 0;
 
@@ -653,10 +896,22 @@ void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
 
 	/* Lock waiters list */
 	ocf_alock_waitlist_lock(alock, entry, flags);
-	ocf_alock_unlock_one_wr_common(alock, entry);
+	ocf_alock_unlock_one_wr_common(alock, entry, granted);
 	ocf_alock_waitlist_unlock(alock, entry, flags);
 }
 
+void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
+		const ocf_cache_line_t entry)
+{
+	struct list_head granted;
+
+	INIT_LIST_HEAD(&granted);
+
+	ocf_alock_unlock_one_wr_deferred(alock, entry, &granted);
+
+	ocf_alock_waiters_resume(alock, &granted, false);
+}
+
 /*
  * Safely remove cache entry lock waiter from waiting list.
  * Request can be assigned with lock asynchronously at any point of time,
@@ -669,28 +924,33 @@ void ocf_alock_waitlist_remove_entry(struct ocf_alock *alock,
 	struct ocf_alock_waiters_list *lst = &alock->waiters_lsts[idx];
 	struct list_head *iter, *next;
 	struct ocf_alock_waiter *waiter;
+	struct list_head granted;
 	unsigned long flags = 0;
 
+	INIT_LIST_HEAD(&granted);
+
 	ocf_alock_waitlist_lock(alock, entry, flags);
 
 	if (ocf_alock_is_index_locked(alock, req, i)) {
 		if (rw == OCF_READ)
-			ocf_alock_unlock_one_rd_common(alock, entry);
+			ocf_alock_unlock_one_rd_common(alock, entry, &granted);
 		else
-			ocf_alock_unlock_one_wr_common(alock, entry);
+			ocf_alock_unlock_one_wr_common(alock, entry, &granted);
 		ocf_alock_mark_index_locked(alock, req, i, false);
 	} else {
 		list_for_each_safe(iter, next, &lst->head) {
 			waiter = list_entry(iter, struct ocf_alock_waiter, item);
 			if (waiter->req == req) {
 				list_del(iter);
-				env_allocator_del(alock->allocator, waiter);
+				ocf_alock_waiter_del(alock, waiter);
 				break;
 			}
 		}
 	}
 
 	ocf_alock_waitlist_unlock(alock, entry, flags);
+
+	ocf_alock_waiters_resume(alock, &granted, false);
 }
 
 int ocf_alock_lock_rd(struct ocf_alock *alock,
@@ -733,6 +993,14 @@ int ocf_alock_lock_rd(struct ocf_alock *alock,
 	return lock;
 }
 
+int ocf_alock_trylock_rd(struct ocf_alock *alock, struct ocf_request *req)
+{
+	ENV_BUG_ON(env_atomic_read(&req->lock_remaining));
+	req->alock_rw = OCF_READ;
+
+	return alock->cbs->lock_entries_fast(alock, req, OCF_READ);
+}
+
 int ocf_alock_lock_wr(struct ocf_alock *alock,
 		struct ocf_request *req, ocf_req_async_lock_cb cmpl)
 {
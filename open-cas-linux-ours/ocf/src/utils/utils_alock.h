@@ -48,9 +48,20 @@ bool ocf_alock_trylock_entry_wr(struct ocf_alock *alock,
 void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
 		const ocf_cache_line_t entry_idx);
 
+void ocf_alock_unlock_one_rd_deferred(struct ocf_alock *alock,
+		const ocf_cache_line_t entry, struct list_head *granted);
+
+void ocf_alock_unlock_one_wr_deferred(struct ocf_alock *alock,
+		const ocf_cache_line_t entry, struct list_head *granted);
+
+void ocf_alock_waiters_resume(struct ocf_alock *alock,
+		struct list_head *granted, bool unlocked);
+
 int ocf_alock_lock_rd(struct ocf_alock *alock,
 		struct ocf_request *req, ocf_req_async_lock_cb cmpl);
 
+int ocf_alock_trylock_rd(struct ocf_alock *alock, struct ocf_request *req);
+
 int ocf_alock_lock_wr(struct ocf_alock *alock,
 		struct ocf_request *req, ocf_req_async_lock_cb cmpl);
 
@@ -91,4 +102,18 @@ void ocf_alock_waitlist_remove_entry(struct ocf_alock *alock,
 bool ocf_alock_trylock_entry_rd_idle(struct ocf_alock *alock,
 		ocf_cache_line_t entry);
 
+bool ocf_alock_trylock_entry_rd_fast(struct ocf_alock *alock,
+		ocf_cache_line_t entry);
+
+bool ocf_alock_trylock_range(struct ocf_alock *alock,
+		ocf_cache_line_t entry, uint32_t count, int rw,
+		struct list_head *granted);
+
+int ocf_alock_waiter_pool_init(ocf_queue_t queue);
+
+void ocf_alock_waiter_pool_deinit(ocf_queue_t queue);
+
+void ocf_alock_get_stats(struct ocf_alock *alock,
+		struct ocf_cache_lock_stats *stats);
+
 #endif
@@ -0,0 +1,173 @@
+/*
+ * Copyright(c) 2012-2022 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_request.h"
+#include "../engine/engine_common.h"
+#include "utils_rcu.h"
+
+void ocf_rcu_init(struct ocf_rcu *rcu, ocf_cache_t cache,
+		struct ocf_refcnt *readers)
+{
+	rcu->cache = cache;
+	rcu->readers = readers;
+	env_atomic_set(&rcu->gp_state, 0);
+	env_atomic_set(&rcu->queued, 1);
+	rcu->req = NULL;
+	env_spinlock_init(&rcu->lock);
+	INIT_LIST_HEAD(&rcu->cbs_wait);
+	INIT_LIST_HEAD(&rcu->cbs_next);
+}
+
+void ocf_rcu_deinit(struct ocf_rcu *rcu)
+{
+	ENV_BUG_ON(env_atomic_read(&rcu->gp_state));
+
+	env_spinlock_destroy(&rcu->lock);
+}
+
+void ocf_rcu_readers_drained(struct ocf_rcu *rcu)
+{
+	/* Counter decrement is a full barrier, pairs with _ocf_rcu_wait() */
+	if (!env_atomic_read(&rcu->gp_state))
+		return;
+
+	if (env_atomic_cmpxchg(&rcu->queued, 0, 1))
+		return;
+
+	ocf_engine_push_req_front(rcu->req, false);
+}
+
+static bool _ocf_rcu_drained(struct ocf_rcu *rcu)
+{
+	/* Order callbacks binding and configuration update before the check */
+	env_smp_mb();
+
+	return !env_atomic_read(&rcu->readers->counter);
+}
+
+/*
+ * Returns true if readers have drained since callbacks in cbs_wait were
+ * queued and grace period request is still owned by the caller, false if it
+ * has to wait for the last reader to kick it.
+ */
+static bool _ocf_rcu_wait(struct ocf_rcu *rcu)
+{
+	if (_ocf_rcu_drained(rcu))
+		return true;
+
+	env_atomic_set(&rcu->queued, 0);
+
+	if (!_ocf_rcu_drained(rcu))
+		return false;
+
+	/* Drained in the meantime - unless some reader has already kicked
+	 * the request, take it back and go on */
+	return !env_atomic_cmpxchg(&rcu->queued, 0, 1);
+}
+
+static void _ocf_rcu_move_callbacks(struct list_head *from,
+		struct list_head *to)
+{
+	struct ocf_rcu_head *head, *tmp;
+
+	list_for_each_entry_safe(head, tmp, from, list)
+		list_move_tail(&head->list, to);
+}
+
+static void _ocf_rcu_run_callbacks(struct list_head *list)
+{
+	struct ocf_rcu_head *head, *tmp;
+
+	list_for_each_entry_safe(head, tmp, list, list) {
+		list_del(&head->list);
+		head->cb(head);
+	}
+}
+
+static int _ocf_rcu_gp_handle(struct ocf_request *req)
+{
+	struct ocf_rcu *rcu = req->priv;
+	struct list_head done;
+	bool next;
+
+	while (true) {
+		if (!_ocf_rcu_wait(rcu))
+			return 0;
+
+		INIT_LIST_HEAD(&done);
+
+		env_spinlock_lock(&rcu->lock);
+		_ocf_rcu_move_callbacks(&rcu->cbs_wait, &done);
+		next = !list_empty(&rcu->cbs_next);
+		if (next) {
+			_ocf_rcu_move_callbacks(&rcu->cbs_next, &rcu->cbs_wait);
+		} else {
+			rcu->req = NULL;
+			env_atomic_set(&rcu->gp_state, 0);
+		}
+		env_spinlock_unlock(&rcu->lock);
+
+		_ocf_rcu_run_callbacks(&done);
+
+		if (!next)
+			break;
+	}
+
+	ocf_req_put(req);
+
+	return 0;
+}
+
+static const struct ocf_io_if _io_if_rcu_gp = {
+	.read = _ocf_rcu_gp_handle,
+	.write = _ocf_rcu_gp_handle,
+};
+
+int ocf_rcu_call(struct ocf_rcu *rcu, struct ocf_rcu_head *head,
+		ocf_rcu_cb_t cb)
+{
+	ocf_cache_t cache = rcu->cache;
+	struct ocf_request *req;
+
+	head->cb = cb;
+
+	env_spinlock_lock(&rcu->lock);
+	if (env_atomic_read(&rcu->gp_state)) {
+		list_add_tail(&head->list, &rcu->cbs_next);
+		env_spinlock_unlock(&rcu->lock);
+		return 0;
+	}
+	env_spinlock_unlock(&rcu->lock);
+
+	if (!cache->mngt_queue)
+		return -OCF_ERR_INVAL;
+
+	req = ocf_req_new(cache->mngt_queue, NULL, 0, 0, 0);
+	if (!req)
+		return -OCF_ERR_NO_MEM;
+
+	req->info.internal = true;
+	req->io_if = &_io_if_rcu_gp;
+	req->priv = rcu;
+
+	env_spinlock_lock(&rcu->lock);
+	if (env_atomic_read(&rcu->gp_state)) {
+		/* Someone else started grace period meanwhile */
+		list_add_tail(&head->list, &rcu->cbs_next);
+		env_spinlock_unlock(&rcu->lock);
+		ocf_req_put(req);
+		return 0;
+	}
+	list_add_tail(&head->list, &rcu->cbs_wait);
+	rcu->req = req;
+	env_atomic_set(&rcu->gp_state, 1);
+	env_spinlock_unlock(&rcu->lock);
+
+	ocf_engine_push_req_front(req, false);
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright(c) 2012-2022 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __UTILS_RCU_H__
+#define __UTILS_RCU_H__
+
+#include "ocf/ocf.h"
+#include "ocf_env.h"
+#include "utils_refcnt.h"
+
+/*
+ * Grace period tracking for configuration published by management path.
+ *
+ * Readers are not tracked separately - every I/O request already holds
+ * metadata reference (cache->refcnt.metadata) for its whole lifetime.
+ * Management operation that only needs to replace some configuration
+ * publishes new version and hands the old one to ocf_rcu_call(). The callback
+ * runs on management queue once the metadata reference counter has been seen
+ * at zero, so neither side has to wait for the other.
+ *
+ * Under sustained I/O the counter may not drop to zero for a long time, hence
+ * grace period is only suitable for releasing retired configuration, never
+ * for anything a management operation has to wait for.
+ */
+
+struct ocf_rcu_head;
+
+typedef void (*ocf_rcu_cb_t)(struct ocf_rcu_head *head);
+
+struct ocf_rcu_head {
+	struct list_head list;
+	ocf_rcu_cb_t cb;
+};
+
+struct ocf_rcu {
+	ocf_cache_t cache;
+
+	struct ocf_refcnt *readers;
+		/*!< Reference counter held by readers */
+
+	env_atomic gp_state;
+		/*!< Grace period in progress, last reader kicks it */
+
+	env_atomic queued;
+		/*!< Set when grace period request must not be pushed by
+		 * readers - it is already queued, running or not allocated */
+
+	struct ocf_request *req;
+
+	env_spinlock lock;
+		/*!< Protects callback lists and grace period start/end */
+
+	struct list_head cbs_wait;
+		/*!< Callbacks waiting for grace period in progress */
+
+	struct list_head cbs_next;
+		/*!< Callbacks queued for next grace period */
+};
+
+void ocf_rcu_init(struct ocf_rcu *rcu, ocf_cache_t cache,
+		struct ocf_refcnt *readers);
+
+void ocf_rcu_deinit(struct ocf_rcu *rcu);
+
+/* Called by reader which has dropped readers counter to zero */
+void ocf_rcu_readers_drained(struct ocf_rcu *rcu);
+
+/* Call cb once all readers present at the time of the call have left read
+ * side. Must be called from management path. Returns error if grace period
+ * could not be started, in which case cb is not going to be called. */
+int ocf_rcu_call(struct ocf_rcu *rcu, struct ocf_rcu_head *head,
+		ocf_rcu_cb_t cb);
+
+#endif /* __UTILS_RCU_H__ */
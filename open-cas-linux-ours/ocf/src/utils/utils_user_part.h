@@ -51,9 +51,15 @@ static inline ocf_part_id_t ocf_user_part_class2id(ocf_cache_t cache, uint64_t c
 	return PARTITION_DEFAULT;
 }
 
+/*
+ * Occupancy is updated in per execution context batches (see ocf_lru.c), so
+ * the value read here may lag behind and transiently go below zero.
+ */
 static inline uint32_t ocf_part_get_occupancy(struct ocf_part *part)
 {
-	return env_atomic_read(&part->runtime->curr_size);
+	int occupancy = env_atomic_read(&part->runtime->curr_size);
+
+	return occupancy > 0 ? occupancy : 0;
 }
 
 static inline uint32_t ocf_user_part_get_min_size(ocf_cache_t cache,
@@ -45,7 +45,11 @@ from .volume import RamVolume, Volume
 
 
 class Backfill(Structure):
-    _fields_ = [("_max_queue_size", c_uint32), ("_queue_unblock_size", c_uint32)]
+    _fields_ = [
+        ("_max_queue_size", c_uint32),
+        ("_queue_unblock_size", c_uint32),
+        ("_mode", c_uint32),
+    ]
 
 
 class CacheMetadataSegment(IntEnum):
@@ -101,7 +105,9 @@ class CacheConfig(Structure):
         ("_locked", c_bool),
         ("_pt_unaligned_io", c_bool),
         ("_use_submit_io_fast", c_bool),
+        ("_inline_resume", c_bool),
         ("_backfill", Backfill),
+        ("_memory_budget", c_uint64),
     ]
 
 
@@ -52,6 +52,7 @@ class DataOps(Structure):
         ("_seek", SEEK),
         ("_copy", COPY),
         ("_secure_erase", SECURE_ERASE),
+        ("_zalloc", ALLOC),
     ]
 
 
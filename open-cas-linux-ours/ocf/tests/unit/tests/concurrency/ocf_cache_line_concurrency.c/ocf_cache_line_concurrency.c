@@ -13,6 +13,8 @@
  *   ocf_req_unlock_wr
  *   ocf_req_unlock_rd
  *   ocf_req_unlock
+ *   _ocf_req_unlock
+ *   ocf_req_unlock_completed
  *   ocf_cache_line_unlock_rd
  *   ocf_cache_line_unlock_wr
  *   ocf_cache_line_try_lock_rd
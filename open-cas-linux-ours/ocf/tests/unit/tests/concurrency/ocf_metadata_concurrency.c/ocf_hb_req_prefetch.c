@@ -0,0 +1,132 @@
+/*
+ * <tested_file_path>src/concurrency/ocf_metadata_concurrency.c</tested_file_path>
+ * <tested_function>ocf_hb_req_prefetch</tested_function>
+ * <functions_to_leave>
+ *	ocf_hb_req_prefetch
+ *	ocf_hb_req_prot_lock_rd
+ *	ocf_hb_req_prot_unlock_rd
+ *	ocf_hb_id_naked_lock
+ *	ocf_hb_id_naked_unlock
+ *	ocf_metadata_seq_write_begin
+ *	ocf_metadata_seq_write_end
+ * </functions_to_leave>
+ */
+
+#undef static
+
+#undef inline
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+#include "ocf_metadata_concurrency.h"
+#include "../metadata/metadata_misc.h"
+
+#include "concurrency/ocf_metadata_concurrency.c/ocf_hb_req_prefetch_generated_wraps.c"
+
+#define MAP_SIZE 64
+
+void __wrap_ocf_metadata_prefetch_hash(struct ocf_cache *cache,
+		ocf_cache_line_t index)
+{
+	check_expected(index);
+	function_called();
+}
+
+static struct ocf_request *alloc_req(unsigned hash_entries)
+{
+	struct ocf_metadata_lock *metadata_lock;
+	struct ocf_request *req;
+	struct ocf_cache *cache;
+	unsigned i;
+
+	cache = test_malloc(sizeof(*cache));
+	metadata_lock = &cache->metadata.lock;
+
+	metadata_lock->num_hash_entries = hash_entries;
+	metadata_lock->hash = test_malloc(hash_entries * sizeof(env_rwsem));
+	metadata_lock->hash_seq = test_calloc(hash_entries, sizeof(env_atomic));
+	for (i = 0; i < hash_entries; i++)
+		assert_int_equal(0, env_rwsem_init(&metadata_lock->hash[i]));
+
+	req = test_malloc(sizeof(*req) + MAP_SIZE * sizeof(req->map[0]));
+	req->map = req->__map;
+	req->cache = cache;
+
+	return req;
+}
+
+static void free_req(struct ocf_request *req)
+{
+	struct ocf_metadata_lock *metadata_lock = &req->cache->metadata.lock;
+	unsigned i;
+
+	for (i = 0; i < metadata_lock->num_hash_entries; i++)
+		env_rwsem_destroy(&metadata_lock->hash[i]);
+
+	test_free(metadata_lock->hash_seq);
+	test_free(metadata_lock->hash);
+	test_free(req->cache);
+	test_free(req);
+}
+
+static void set_req_hash(struct ocf_request *req, unsigned first,
+		unsigned count)
+{
+	unsigned i;
+
+	req->core_line_count = count;
+
+	for (i = 0; i < count; i++) {
+		req->map[i].hash = (first + i) %
+				req->cache->metadata.lock.num_hash_entries;
+	}
+}
+
+static void ocf_hb_req_prefetch_test01(void **state)
+{
+	struct ocf_request *req = alloc_req(5);
+	unsigned expected[] = {0, 1, 3, 4};
+	unsigned i;
+
+	print_test_description("Every request hash bucket is prefetched once, "
+			"small requests are not prefetched\n");
+
+	set_req_hash(req, 3, 2);
+	ocf_hb_req_prot_lock_rd(req);
+	ocf_hb_req_prot_unlock_rd(req);
+
+	set_req_hash(req, 3, 4);
+	for (i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+		expect_function_call(__wrap_ocf_metadata_prefetch_hash);
+		expect_value(__wrap_ocf_metadata_prefetch_hash, index,
+				expected[i]);
+	}
+	ocf_hb_req_prot_lock_rd(req);
+	ocf_hb_req_prot_unlock_rd(req);
+
+	set_req_hash(req, 3, 9);
+	for (i = 0; i < 5; i++) {
+		expect_function_call(__wrap_ocf_metadata_prefetch_hash);
+		expect_value(__wrap_ocf_metadata_prefetch_hash, index, i);
+	}
+	ocf_hb_req_prot_lock_rd(req);
+	ocf_hb_req_prot_unlock_rd(req);
+
+	free_req(req);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(ocf_hb_req_prefetch_test01),
+	};
+
+	print_message("Unit test for ocf_hb_req_prefetch\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright(c) 2012-2022 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * <tested_file_path>src/ocf_request.c</tested_file_path>
+ * <tested_function>ocf_req_new</tested_function>
+ * <functions_to_leave>
+ *	ocf_req_allocator_init
+ *	ocf_req_allocator_deinit
+ *	ocf_req_size_idx
+ *	ocf_req_cache_init
+ *	ocf_req_cache_deinit
+ *	ocf_req_cache_free_list
+ *	ocf_req_cache_collect
+ *	ocf_req_cache_get
+ *	ocf_req_cache_put
+ *	ocf_req_reinit
+ *	ocf_req_put
+ *	list_add
+ *	list_add_tail
+ *	list_empty
+ *	list_del
+ *	list_move_tail
+ * </functions_to_leave>
+ */
+
+#undef static
+
+#undef inline
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+#include "ocf/ocf.h"
+#include "ocf_request.h"
+#include "ocf_cache_priv.h"
+#include "ocf_ctx_priv.h"
+#include "ocf_queue_priv.h"
+#include "utils/utils_cache_line.h"
+
+#include "ocf_request.c/ocf_req_cache_generated_wraps.c"
+
+#define TEST_LINE_SIZE 4096
+#define TEST_REUSE_ITERATIONS 16
+
+struct test_ctx {
+	struct ocf_ctx ctx;
+	struct ocf_cache *cache;
+	struct ocf_queue *queue;
+};
+
+uint64_t __wrap_ocf_bytes_2_lines(struct ocf_cache *cache, uint64_t bytes)
+{
+	return bytes / TEST_LINE_SIZE;
+}
+
+static int setup(void **state)
+{
+	struct test_ctx *t;
+
+	t = env_zalloc(sizeof(*t), ENV_MEM_NORMAL);
+	assert_non_null(t);
+
+	t->cache = env_zalloc(sizeof(*t->cache), ENV_MEM_NORMAL);
+	assert_non_null(t->cache);
+
+	t->queue = env_zalloc(sizeof(*t->queue), ENV_MEM_NORMAL);
+	assert_non_null(t->queue);
+
+	assert_int_equal(0, ocf_req_allocator_init(&t->ctx));
+
+	t->cache->owner = &t->ctx;
+	t->queue->cache = t->cache;
+	assert_int_equal(0, ocf_req_cache_init(t->queue));
+
+	*state = t;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct test_ctx *t = *state;
+
+	ocf_req_cache_deinit(t->queue);
+	ocf_req_allocator_deinit(&t->ctx);
+
+	env_free(t->queue);
+	env_free(t->cache);
+	env_free(t);
+
+	return 0;
+}
+
+static void ocf_req_cache_test01(void **state)
+{
+	struct test_ctx *t = *state;
+	struct ocf_request *req, *recycled;
+
+	print_test_description("Completed request is reused by the same queue "
+			"and comes back clean\n");
+
+	req = ocf_req_new(t->queue, NULL, 0, 4 * TEST_LINE_SIZE, OCF_WRITE);
+	assert_non_null(req);
+	assert_int_equal(4, req->core_line_count);
+	assert_ptr_equal(req->__map, req->map);
+
+	req->error = -1;
+	req->cp_data = (void *)req;
+	req->map[3].status = 1;
+	req->alock_status[3] = 1;
+
+	ocf_req_put(req);
+	assert_int_equal(1, env_atomic_read(&t->queue->req_cached));
+
+	recycled = ocf_req_new(t->queue, NULL, 0, 3 * TEST_LINE_SIZE,
+			OCF_READ);
+	assert_ptr_equal(req, recycled);
+	assert_int_equal(0, env_atomic_read(&t->queue->req_cached));
+	assert_int_equal(1, env_atomic64_read(&t->queue->req_recycled));
+
+	assert_int_equal(0, recycled->error);
+	assert_null(recycled->cp_data);
+	assert_int_equal(OCF_READ, recycled->rw);
+	assert_int_equal(3, recycled->core_line_count);
+	assert_int_equal(3, recycled->alloc_core_line_count);
+	assert_ptr_equal(recycled->__map, recycled->map);
+	assert_int_equal(0, recycled->map[2].status);
+	assert_int_equal(0, recycled->alock_status[2]);
+
+	ocf_req_put(recycled);
+}
+
+static void ocf_req_cache_test02(void **state)
+{
+	struct test_ctx *t = *state;
+	struct ocf_request *small, *big;
+
+	print_test_description("Requests are reused only within the same "
+			"size class\n");
+
+	small = ocf_req_new(t->queue, NULL, 0, TEST_LINE_SIZE, OCF_READ);
+	assert_non_null(small);
+	ocf_req_put(small);
+
+	big = ocf_req_new(t->queue, NULL, 0, 64 * TEST_LINE_SIZE, OCF_READ);
+	assert_non_null(big);
+	assert_ptr_not_equal(small, big);
+	assert_int_equal(1, env_atomic_read(&t->queue->req_cached));
+
+	ocf_req_put(big);
+	assert_int_equal(2, env_atomic_read(&t->queue->req_cached));
+}
+
+static void ocf_req_cache_test03(void **state)
+{
+	struct test_ctx *t = *state;
+	struct ocf_request *first, *req;
+	int i;
+
+	print_test_description("Steady stream of requests is served from queue "
+			"free list and each request is reinitialized\n");
+
+	first = ocf_req_new(t->queue, NULL, 0, 8 * TEST_LINE_SIZE, OCF_READ);
+	assert_non_null(first);
+	ocf_req_put(first);
+
+	for (i = 0; i < TEST_REUSE_ITERATIONS; i++) {
+		req = ocf_req_new(t->queue, NULL, i * TEST_LINE_SIZE,
+				8 * TEST_LINE_SIZE, i % 2 ? OCF_WRITE : OCF_READ);
+		assert_ptr_equal(first, req);
+
+		assert_int_equal(1, env_atomic_read(&req->ref_count));
+		assert_int_equal(0, req->error);
+		assert_int_equal(i * TEST_LINE_SIZE, req->byte_position);
+		assert_int_equal(i % 2 ? OCF_WRITE : OCF_READ, req->rw);
+		assert_int_equal(0, req->map[7].status);
+
+		req->error = -1;
+		req->map[7].status = 1;
+
+		ocf_req_put(req);
+	}
+
+	assert_int_equal(1, env_atomic64_read(&t->queue->req_allocated));
+	assert_int_equal(TEST_REUSE_ITERATIONS,
+			env_atomic64_read(&t->queue->req_recycled));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(ocf_req_cache_test01,
+				setup, teardown),
+		cmocka_unit_test_setup_teardown(ocf_req_cache_test02,
+				setup, teardown),
+		cmocka_unit_test_setup_teardown(ocf_req_cache_test03,
+				setup, teardown),
+	};
+
+	print_message("Unit test of src/ocf_request.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright(c) 2012-2022 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * <tested_file_path>src/ocf_request.c</tested_file_path>
+ * <tested_function>ocf_req_allocator_init</tested_function>
+ * <functions_to_leave>
+ *	ocf_req_allocator_deinit
+ * </functions_to_leave>
+ */
+
+#undef static
+
+#undef inline
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+#include "ocf/ocf.h"
+#include "ocf_request.h"
+#include "ocf_cache_priv.h"
+#include "ocf_ctx_priv.h"
+
+#include "ocf_request.c/ocf_req_layout_generated_wraps.c"
+
+#define TEST_CACHE_LINE 64
+
+struct test_req_field {
+	const char *name;
+	const char *user;
+	size_t offset;
+	size_t size;
+};
+
+#define TEST_FIELD(_field, _user) { \
+	.name = #_field, \
+	.user = _user, \
+	.offset = offsetof(struct ocf_request, _field), \
+	.size = sizeof(((struct ocf_request *)0)->_field), \
+}
+
+/*
+ * Every field read or written for a read/write hit going through
+ * ocf_core_volume_submit_io(), ocf_read_fast()/ocf_write_fast() and request
+ * completion, together with the function touching it. Bitfields (rw, d2c,
+ * lock_idx, alock_rw, ...) sit between part_id and cache_mode.
+ */
+static const struct test_req_field test_fields[] = {
+	TEST_FIELD(ref_count, "ocf_req_new, ocf_req_put"),
+	TEST_FIELD(req_remaining, "_ocf_read_fast_complete"),
+	TEST_FIELD(lock_remaining, "ocf_alock_lock_rd"),
+	TEST_FIELD(error, "_ocf_read_fast_complete"),
+	TEST_FIELD(cache, "ocf_req_new"),
+	TEST_FIELD(core, "ocf_req_new"),
+	TEST_FIELD(io_queue, "ocf_req_new"),
+	TEST_FIELD(data, "ocf_core_io_set_data"),
+	TEST_FIELD(byte_position, "ocf_req_new"),
+	TEST_FIELD(core_line_first, "ocf_engine_lookup"),
+	TEST_FIELD(core_line_last, "ocf_engine_lookup"),
+	TEST_FIELD(byte_length, "ocf_req_new"),
+	TEST_FIELD(core_line_count, "ocf_engine_lookup"),
+	TEST_FIELD(map, "ocf_engine_lookup"),
+	TEST_FIELD(alock_status, "ocf_alock_mark_index_locked"),
+	TEST_FIELD(part_id, "ocf_core_volume_submit_io"),
+	TEST_FIELD(cache_mode, "ocf_core_submit_io_fast"),
+	TEST_FIELD(complete, "ocf_core_volume_submit_io"),
+	TEST_FIELD(alloc_core_line_count, "ocf_req_new, ocf_req_cache_put"),
+	TEST_FIELD(map_alloc_count, "ocf_req_put"),
+	TEST_FIELD(info.hit_no, "ocf_engine_is_hit"),
+	TEST_FIELD(info.invalid_no, "ocf_engine_lookup"),
+	TEST_FIELD(info.re_part_no, "ocf_engine_io_count"),
+	TEST_FIELD(info.seq_no, "ocf_engine_io_count"),
+	TEST_FIELD(info.insert_no, "ocf_engine_lookup"),
+	TEST_FIELD(info.dirty_all, "ocf_engine_lookup"),
+	TEST_FIELD(info.dirty_any, "ocf_engine_lookup"),
+	TEST_FIELD(list, "ocf_req_cache_put, ocf_req_cache_get"),
+	TEST_FIELD(ioi.meta.volume, "ocf_io_new"),
+	TEST_FIELD(ioi.meta.ops, "ocf_io_new"),
+	TEST_FIELD(ioi.meta.ref_count, "ocf_io_get, ocf_io_put"),
+	TEST_FIELD(ioi.io.addr, "ocf_core_volume_submit_io"),
+	TEST_FIELD(ioi.io.flags, "ocf_core_volume_submit_io"),
+	TEST_FIELD(ioi.io.bytes, "ocf_core_volume_submit_io"),
+	TEST_FIELD(ioi.io.io_class, "ocf_core_volume_submit_io"),
+	TEST_FIELD(ioi.io.dir, "ocf_core_volume_submit_io"),
+	TEST_FIELD(ioi.io.io_queue, "ocf_core_volume_submit_io"),
+	TEST_FIELD(ioi.io.start, "ocf_io_start"),
+	TEST_FIELD(ioi.io.priv1, "ocf_io_end"),
+	TEST_FIELD(ioi.io.priv2, "ocf_io_end"),
+	TEST_FIELD(ioi.io.end, "ocf_io_end"),
+};
+
+static void ocf_req_layout_test01(void **state)
+{
+	uint64_t lines = 0;
+	size_t first, last;
+	int i;
+
+	print_test_description("Fast path fields of request fit in its hot "
+			"part\n");
+
+	print_message("struct ocf_request {\n");
+	for (i = 0; i < ARRAY_SIZE(test_fields); i++) {
+		first = test_fields[i].offset / TEST_CACHE_LINE;
+		last = (test_fields[i].offset + test_fields[i].size - 1) /
+				TEST_CACHE_LINE;
+
+		print_message("\t%-24s /* %4zu %4zu */ line %zu (%s)\n",
+				test_fields[i].name, test_fields[i].offset,
+				test_fields[i].size, first, test_fields[i].user);
+
+		assert_true(test_fields[i].offset + test_fields[i].size <=
+				OCF_REQ_HOT_SIZE);
+		for (; first <= last; first++)
+			lines |= 1ULL << first;
+	}
+	print_message("}; /* size: %zu, cache lines: %zu */\n",
+			sizeof(struct ocf_request),
+			(sizeof(struct ocf_request) + TEST_CACHE_LINE - 1) /
+					TEST_CACHE_LINE);
+	print_message("fast path cache lines touched per I/O: %d\n",
+			__builtin_popcountll(lines));
+
+	/* Hot part has no holes - every line of it is touched */
+	assert_int_equal(__builtin_popcountll(lines),
+			OCF_REQ_HOT_SIZE / TEST_CACHE_LINE);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(ocf_req_layout_test01),
+	};
+
+	print_message("Unit test of src/ocf_request.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright(c) 2012-2022 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * <tested_file_path>src/utils/utils_rcu.c</tested_file_path>
+ * <tested_function>ocf_rcu_call</tested_function>
+ * <functions_to_leave>
+ *	ocf_rcu_init
+ *	ocf_rcu_deinit
+ *	ocf_rcu_readers_drained
+ *	_ocf_rcu_drained
+ *	_ocf_rcu_wait
+ *	_ocf_rcu_move_callbacks
+ *	_ocf_rcu_run_callbacks
+ *	_ocf_rcu_gp_handle
+ *	INIT_LIST_HEAD
+ *	list_add_tail
+ *	list_empty
+ *	list_del
+ *	list_move_tail
+ * </functions_to_leave>
+ */
+
+#undef static
+
+#undef inline
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+#include "ocf/ocf.h"
+#include "ocf_cache_priv.h"
+#include "ocf_queue_priv.h"
+#include "ocf_request.h"
+#include "engine/cache_engine.h"
+#include "utils/utils_rcu.h"
+
+#include "utils/utils_rcu.c/utils_rcu_call_generated_wraps.c"
+
+struct test_ctx {
+	struct ocf_cache cache;
+	struct ocf_queue mngt_queue;
+	struct ocf_refcnt readers;
+	struct ocf_request req;
+	struct ocf_rcu rcu;
+	struct ocf_rcu_head heads[2];
+};
+
+struct ocf_request *__wrap_ocf_req_new(ocf_queue_t queue, ocf_core_t core,
+		uint64_t addr, uint32_t bytes, int rw)
+{
+	struct test_ctx *t = mock_ptr_type(struct test_ctx *);
+
+	return &t->req;
+}
+
+void __wrap_ocf_req_put(struct ocf_request *req)
+{
+	function_called();
+}
+
+void __wrap_ocf_engine_push_req_front(struct ocf_request *req, bool allow_sync)
+{
+	function_called();
+}
+
+static void test_cb(struct ocf_rcu_head *head)
+{
+	function_called();
+	check_expected_ptr(head);
+}
+
+/* Emulate a reader entering a grace period in progress from callback */
+static void test_cb_reader_enters(struct ocf_rcu_head *head)
+{
+	struct test_ctx *t = container_of(head, struct test_ctx, heads[0]);
+
+	function_called();
+	env_atomic_inc(&t->readers.counter);
+}
+
+static void test_readers_leave(struct test_ctx *t)
+{
+	env_atomic_set(&t->readers.counter, 0);
+	ocf_rcu_readers_drained(&t->rcu);
+}
+
+static void test_run_gp(struct test_ctx *t)
+{
+	t->rcu.req->io_if->read(t->rcu.req);
+}
+
+static void test_call(struct test_ctx *t, int i, ocf_rcu_cb_t cb)
+{
+	will_return_maybe(__wrap_ocf_req_new, t);
+	assert_int_equal(0, ocf_rcu_call(&t->rcu, &t->heads[i], cb));
+}
+
+static int setup(void **state)
+{
+	struct test_ctx *t;
+
+	t = env_zalloc(sizeof(*t), ENV_MEM_NORMAL);
+	assert_non_null(t);
+
+	t->cache.mngt_queue = &t->mngt_queue;
+	ocf_rcu_init(&t->rcu, &t->cache, &t->readers);
+
+	*state = t;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct test_ctx *t = *state;
+
+	ocf_rcu_deinit(&t->rcu);
+	env_free(t);
+
+	return 0;
+}
+
+static void ocf_rcu_call_test01(void **state)
+{
+	struct test_ctx *t = *state;
+
+	print_test_description("Callback runs on first pass without readers");
+
+	expect_function_call(__wrap_ocf_engine_push_req_front);
+	test_call(t, 0, test_cb);
+
+	expect_function_call(test_cb);
+	expect_value(test_cb, head, &t->heads[0]);
+	expect_function_call(__wrap_ocf_req_put);
+	test_run_gp(t);
+
+	assert_int_equal(0, env_atomic_read(&t->rcu.gp_state));
+	assert_null(t->rcu.req);
+}
+
+static void ocf_rcu_call_test02(void **state)
+{
+	struct test_ctx *t = *state;
+
+	print_test_description("Grace period waits for readers to drain");
+
+	env_atomic_set(&t->readers.counter, 2);
+
+	expect_function_call(__wrap_ocf_engine_push_req_front);
+	test_call(t, 0, test_cb);
+
+	/* Readers present - request parks waiting for a kick */
+	test_run_gp(t);
+	assert_int_equal(1, env_atomic_read(&t->rcu.gp_state));
+	assert_int_equal(0, env_atomic_read(&t->rcu.queued));
+
+	/* Last reader leaves and pushes the request again */
+	expect_function_call(__wrap_ocf_engine_push_req_front);
+	test_readers_leave(t);
+	assert_int_equal(1, env_atomic_read(&t->rcu.queued));
+
+	expect_function_call(test_cb);
+	expect_value(test_cb, head, &t->heads[0]);
+	expect_function_call(__wrap_ocf_req_put);
+	test_run_gp(t);
+
+	assert_int_equal(0, env_atomic_read(&t->rcu.gp_state));
+}
+
+static void ocf_rcu_call_test03(void **state)
+{
+	struct test_ctx *t = *state;
+
+	print_test_description("Drain without grace period or parked request "
+			"does not push anything");
+
+	/* No grace period */
+	test_readers_leave(t);
+
+	env_atomic_set(&t->readers.counter, 1);
+
+	expect_function_call(__wrap_ocf_engine_push_req_front);
+	test_call(t, 0, test_cb);
+
+	/* Request still queued - draining must not push it second time */
+	test_readers_leave(t);
+
+	expect_function_call(test_cb);
+	expect_value(test_cb, head, &t->heads[0]);
+	expect_function_call(__wrap_ocf_req_put);
+	test_run_gp(t);
+
+	/* Grace period done - nothing to kick */
+	test_readers_leave(t);
+}
+
+static void ocf_rcu_call_test04(void **state)
+{
+	struct test_ctx *t = *state;
+
+	print_test_description("Callback queued during running grace period "
+			"waits for readers present at the time it was queued");
+
+	env_atomic_set(&t->readers.counter, 1);
+
+	expect_function_call(__wrap_ocf_engine_push_req_front);
+	test_call(t, 0, test_cb_reader_enters);
+
+	test_run_gp(t);
+
+	/* Grace period running - no new request, callback goes to next one */
+	test_call(t, 1, test_cb);
+	assert_false(list_empty(&t->rcu.cbs_next));
+
+	/* First callback lets new reader in before second one is checked */
+	expect_function_call(__wrap_ocf_engine_push_req_front);
+	test_readers_leave(t);
+	expect_function_call(test_cb_reader_enters);
+	test_run_gp(t);
+
+	assert_int_equal(1, env_atomic_read(&t->rcu.gp_state));
+	assert_true(list_empty(&t->rcu.cbs_next));
+	assert_false(list_empty(&t->rcu.cbs_wait));
+
+	expect_function_call(__wrap_ocf_engine_push_req_front);
+	test_readers_leave(t);
+
+	expect_function_call(test_cb);
+	expect_value(test_cb, head, &t->heads[1]);
+	expect_function_call(__wrap_ocf_req_put);
+	test_run_gp(t);
+
+	assert_int_equal(0, env_atomic_read(&t->rcu.gp_state));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(ocf_rcu_call_test01,
+				setup, teardown),
+		cmocka_unit_test_setup_teardown(ocf_rcu_call_test02,
+				setup, teardown),
+		cmocka_unit_test_setup_teardown(ocf_rcu_call_test03,
+				setup, teardown),
+		cmocka_unit_test_setup_teardown(ocf_rcu_call_test04,
+				setup, teardown),
+	};
+
+	print_message("Unit test of src/utils/utils_rcu.c");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}